@@ -14,18 +14,53 @@
 #ifndef IOPTALGORITHM_H
 #define IOPTALGORITHM_H
 
+#include <optional>
+#include <vector>
+
+#include "OptBoundaries.h"
+#include "OptCalculation.h"
+#include "OptRandom.h"
+#include "OptStorage.h"
+
 namespace cppOpt {
 
 using namespace std;
 
-template<typename T>
+template<typename T, size_t N = dynamicSize>
 class IOptAlgorithm {
    public:
-    virtual OptCalculation<T> get_next_calculation(
-        vector<OptCalculation<T>> const& previous,
-        OptCalculation<T> const*         best) = 0;
+    virtual OptCalculation<T, N> get_next_calculation(OptCalculation<T, N> const* best, OptRandom& random) = 0;
+
+    ///called with every finished calculation, algorithms keep whatever state they need of it
+    virtual void on_result(OptCalculation<T, N> const& /*result*/) {}
+
+    ///appends up to n candidates to candidates, which are evaluated in parallel
+    ///the default only hands out a single one, since get_next_calculation may depend on the result of its predecessor
+    virtual void ask(
+        size_t                        n,
+        OptCalculation<T, N> const*   best,
+        OptRandom&                    random,
+        vector<OptCalculation<T, N>>& candidates) {
+        if (n > 0)
+            candidates.push_back(get_next_calculation(best, random));
+    }
+
+    ///appends a single candidate replacing a rejected one of the last ask, if there is one
+    ///called before the results of the last ask are told, the default asks for one more
+    virtual void ask_replacement(
+        OptCalculation<T, N> const*   best,
+        OptRandom&                    random,
+        vector<OptCalculation<T, N>>& candidates) {
+        ask(1, best, random, candidates);
+    }
+
+    ///called with the results of all candidates of the last ask, before asking again
+    virtual void tell(vector<OptCalculation<T, N>> const& results) {
+        for (auto const& result : results)
+            on_result(result);
+    }
 
-    virtual OptBoundaries<T> const& get_boundaries() = 0;
+    virtual OptBoundaries<T, N> const& get_boundaries() = 0;
 
     virtual ~IOptAlgorithm(){};
 };
@@ -0,0 +1,38 @@
+/*
+    Copyright (c) 2017 Martin Buck
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation the rights to
+    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+    The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+    OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef IOPTDESIGN_H
+#define IOPTDESIGN_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cppOpt {
+
+using namespace std;
+
+///a design of start points within the unit cube [0, 1)^d
+///every coordinate of every point can be computed directly, so children can skip ahead to their own points
+class IOptDesign {
+   public:
+    virtual double coordinate(uint64_t index, size_t dimension) const = 0;
+
+    ///the number of dimensions the design supports
+    virtual size_t max_dimensions() const = 0;
+
+    virtual ~IOptDesign() = default;
+};
+
+}  // namespace cppOpt
+
+#endif  // IOPTDESIGN_H
@@ -0,0 +1,262 @@
+/*
+    Copyright (c) 2017 Martin Buck
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation the rights to
+    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+    The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+    OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef OPTARCHIVE_H
+#define OPTARCHIVE_H
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "OptCalculation.h"
+#include "OptHelper.h"
+#include "OptHistory.h"
+#include "OptStorage.h"
+#include "OptTarget.h"
+
+namespace cppOpt {
+
+using namespace std;
+
+enum class OptArchivePolicy {
+    NONE,  //nothing, not even the best calculation, see OptCoordinator::get_best_calculation
+    ALL,
+    BEST,  //the best capacity calculations
+    LAST,  //a ring of the last capacity calculations
+    FILE   //every calculation is written to a file
+};
+
+///finished calculations as passed to the calculation function, kept according to a policy
+///the best calculation is always tracked on insert
+template<typename T, size_t N = dynamicSize>
+class OptArchive final {
+    OptArchivePolicy
+        policy;
+
+    OptTarget
+        optTarget;
+
+    T
+        targetValue;
+
+    size_t
+        capacity,
+        nAdded{0},
+        nextIndex{0};  //oldest element of the ring
+
+    schema_t
+        schema;
+
+    OptHistory<T, N>  //ALL
+        history;
+
+    vector<OptCalculation<T, N>>  //BEST ordered best first, LAST as ring
+        calculations;
+
+    ofstream  //FILE
+        file;
+
+    optional<OptCalculation<T, N>>
+        best{nullopt};
+
+    //------------------------------------------------------------------------------
+
+   public:
+    OptArchive(
+        OptArchivePolicy policy,
+        OptTarget        optTarget,
+        T                targetValue,
+        size_t           capacity = 0,
+        string const&    path     = "") :
+
+                                 policy(policy),
+                                 optTarget(optTarget),
+                                 targetValue(move(targetValue)),
+                                 capacity(capacity) {
+        switch (policy) {
+            case OptArchivePolicy::BEST:
+            case OptArchivePolicy::LAST:
+                if (capacity == 0)
+                    throw runtime_error("Archive requires a capacity");
+                calculations.reserve(capacity);
+                break;
+
+            case OptArchivePolicy::FILE:
+                file.open(path);
+                if (!file)
+                    throw runtime_error("Unable to open archive file " + path);
+                file.precision(numeric_limits<T>::max_digits10);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    void add(OptCalculation<T, N> const& optCalculation, size_t childId = 0, size_t sequenceNumber = 0) {
+        if (!schema)
+            schema = optCalculation.get_schema();
+        else if (schema != optCalculation.get_schema() && !(schema && optCalculation.get_schema() && schema->same_as(*optCalculation.get_schema())))
+            throw runtime_error("All calculations of an archive must use the same parameters");
+
+        if (!best || OptHelper<T, N>::result_better(optCalculation, *best, optTarget, targetValue))
+            best = optCalculation;
+
+        switch (policy) {
+            case OptArchivePolicy::NONE:
+                break;
+
+            case OptArchivePolicy::ALL:
+                history.push_back(optCalculation, childId, sequenceNumber);
+                break;
+
+            case OptArchivePolicy::BEST:
+                add_best(optCalculation);
+                break;
+
+            case OptArchivePolicy::LAST:
+                if (calculations.size() < capacity)
+                    calculations.push_back(optCalculation);
+                else {
+                    calculations[nextIndex] = optCalculation;
+                    nextIndex               = (nextIndex + 1) % capacity;
+                }
+                break;
+
+            case OptArchivePolicy::FILE:
+                add_file(optCalculation);
+                break;
+
+            default:  //NONE
+                break;
+        }
+
+        ++nAdded;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///nullopt as long as nothing was added
+    optional<OptCalculation<T, N>> const& get_best() const {
+        return best;
+    }
+
+    //------------------------------------------------------------------------------
+
+    OptArchivePolicy get_policy() const {
+        return policy;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///number of calculations added, including the ones which aren't kept
+    size_t n_added() const {
+        return nAdded;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///number of calculations kept in memory
+    size_t size() const {
+        switch (policy) {
+            case OptArchivePolicy::ALL:
+                return history.size();
+
+            case OptArchivePolicy::BEST:
+            case OptArchivePolicy::LAST:
+                return calculations.size();
+
+            default:  //NONE, FILE
+                return 0;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///the calculations kept in memory, in order of insertion or best first for BEST
+    vector<OptCalculation<T, N>> get_calculations() const {
+        vector<OptCalculation<T, N>> out;
+
+        switch (policy) {
+            case OptArchivePolicy::ALL:
+                out.reserve(history.size());
+                for (size_t i = 0; i < history.size(); ++i)
+                    out.push_back(history[i]);
+                break;
+
+            case OptArchivePolicy::BEST:
+                out = calculations;
+                break;
+
+            case OptArchivePolicy::LAST:
+                out.reserve(calculations.size());
+                for (size_t i = 0; i < calculations.size(); ++i)
+                    out.push_back(calculations[(nextIndex + i) % calculations.size()]);
+                break;
+
+            default:  //NONE, FILE
+                break;
+        }
+        return out;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///only available for ALL
+    OptHistory<T, N> const& get_history() const {
+        return history;
+    }
+
+    //------------------------------------------------------------------------------
+
+   private:
+    void add_best(OptCalculation<T, N> const& optCalculation) {
+        //behind all which are at least as good, so older ones are preferred on ties
+        auto position = find_if(calculations.begin(), calculations.end(), [this, &optCalculation](OptCalculation<T, N> const& other) {
+            return OptHelper<T, N>::result_better(optCalculation, other, optTarget, targetValue);
+        });
+
+        const size_t index = position - calculations.begin();
+        if (index >= capacity)
+            return;
+
+        if (calculations.size() == capacity)
+            calculations.pop_back();
+
+        calculations.insert(calculations.begin() + index, optCalculation);
+    }
+
+    //------------------------------------------------------------------------------
+
+    void add_file(OptCalculation<T, N> const& optCalculation) {
+        if (nAdded == 0)
+            file << optCalculation.to_string_header() << '\n';
+
+        for (size_t i = 0; i < optCalculation.size(); ++i)
+            file << optCalculation.get_parameter(i) << ' ';
+
+        file << optCalculation.result << '\n';
+    }
+
+    //------------------------------------------------------------------------------
+};
+
+}  // namespace cppOpt
+
+#endif  // OPTARCHIVE_H
@@ -14,27 +14,478 @@
 #ifndef OPTBOUNDARIES_H
 #define OPTBOUNDARIES_H
 
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
 #include <map>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "OptBoundary.h"
+#include "OptParameterSchema.h"
+#include "OptStorage.h"
 
 namespace cppOpt {
 
 using namespace std;
 
-template<typename T>
+template<typename T, size_t N>
+class OptCell;
+
+///how split partitions several parameters
+enum class OptSplit {
+    GRID,  //the same number of slices per parameter, at most the requested number of cells
+    KD     //halving the longest side recursively, exactly the requested number of cells
+};
+
+template<typename T, size_t N = dynamicSize>
 class OptBoundaries {
    private:
     map<string, OptBoundary<T> >
         optBoundaries;
 
+    schema_t
+        schema{make_shared<const OptParameterSchema>()};
+
+    storage_t<T, N>  //index aligned with the schema
+        mins{},
+        maxs{},
+        ranges{},
+        invRanges{},
+        transformedMins{},
+        transformedRanges{},
+        invTransformedRanges{};
+
+    storage_t<OptTransform, N>
+        transforms{};
+
+    storage_t<OptBoundaryPolicy, N>
+        policies{};
+
+    storage_t<OptKind, N>
+        kinds{};
+
+    storage_t<T, N>  //number of values of discrete parameters, 0 for continuous ones
+        nLevels{};
+
+    storage_t<T, N>  //the unit value inactive parameters are held at
+        canonicals{};
+
+    map<string, pair<string, vector<T>>>  //by name of the conditional parameter, its parent and the values of the parent activating it
+        conditions;
+
+    storage_t<size_t, N>  //index of the parent of conditional parameters, noParent otherwise
+        parents{};
+
+    vector<vector<unsigned char>>  //per conditional parameter, whether a value of its parent activates it
+        activeLevels;
+
+    bool
+        allLinear{true},
+        allReject{true},
+        allContinuous{true},
+        allDiscrete{true},
+        hasConditions{false};
+
+    static constexpr size_t
+        noParent = numeric_limits<size_t>::max();
+
     //------------------------------------------------------------------------------
 
    public:
     void add_boundary(const OptBoundary<T>& optBoundary) {
+        if (N != dynamicSize && optBoundaries.size() >= N && optBoundaries.find(optBoundary.name) == optBoundaries.end())
+            throw runtime_error("Can't add more boundaries than the fixed number of parameters");
+
+        if (optBoundary.transform == OptTransform::LOG && (optBoundary.min <= 0 || optBoundary.max <= 0))
+            throw runtime_error("Logarithmic boundaries require min and max to be greater than 0");
+
+        if (optBoundary.transform == OptTransform::LOGIT && (optBoundary.min <= 0 || optBoundary.max <= 0 || optBoundary.min >= 1 || optBoundary.max >= 1))
+            throw runtime_error("Logit boundaries require min and max to be within (0, 1)");
+
+        if (optBoundary.kind != OptKind::CONTINUOUS && (optBoundary.transform != OptTransform::LINEAR || optBoundary.min > optBoundary.max || floor(optBoundary.min) != optBoundary.min || floor(optBoundary.max) != optBoundary.max))
+            throw runtime_error("Discrete boundaries require integral min <= max and a linear transform");
+
         optBoundaries.insert(make_pair(optBoundary.name, optBoundary));
+
+        vector<string> names;
+        names.reserve(optBoundaries.size());
+
+        if constexpr (N == dynamicSize) {
+            mins.resize(optBoundaries.size());
+            maxs.resize(optBoundaries.size());
+            ranges.resize(optBoundaries.size());
+            invRanges.resize(optBoundaries.size());
+            transformedMins.resize(optBoundaries.size());
+            transformedRanges.resize(optBoundaries.size());
+            invTransformedRanges.resize(optBoundaries.size());
+            transforms.resize(optBoundaries.size());
+            policies.resize(optBoundaries.size());
+            kinds.resize(optBoundaries.size());
+            nLevels.resize(optBoundaries.size());
+            canonicals.resize(optBoundaries.size());
+            parents.resize(optBoundaries.size());
+        }
+
+        allLinear     = true;
+        allReject     = true;
+        allContinuous = true;
+        allDiscrete   = true;
+
+        size_t i = 0;
+        for (auto const& boundary : optBoundaries) {
+            names.push_back(boundary.first);
+            set_index(i, boundary.second);
+            allLinear &= transforms[i] == OptTransform::LINEAR;
+            allReject &= policies[i] == OptBoundaryPolicy::REJECT;
+            allContinuous &= kinds[i] == OptKind::CONTINUOUS;
+            allDiscrete &= kinds[i] != OptKind::CONTINUOUS;
+            ++i;
+        }
+
+        schema = make_shared<const OptParameterSchema>(move(names));
+        resolve_conditions();
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///the parameter name is only active if its discrete parent is active and takes one of the values
+    ///inactive parameters are held at their canonical value, see deactivate, but still stored within every calculation
+    void set_condition(string const& name, string const& parent, vector<T> values) {
+        if (!schema->contains(name) || !schema->contains(parent))
+            throw runtime_error("Conditions require both parameters to have boundaries");
+
+        if (kinds[schema->index_of(parent)] == OptKind::CONTINUOUS)
+            throw runtime_error("Conditions require a discrete parent");
+
+        for (string ancestor = parent;;) {
+            if (ancestor == name)
+                throw runtime_error("Conditions mustn't form a cycle");
+
+            auto condition = conditions.find(ancestor);
+            if (condition == conditions.end())
+                break;
+            ancestor = condition->second.first;
+        }
+
+        conditions[name] = make_pair(parent, move(values));
+        resolve_conditions();
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///replaces min and max of the parameter at index, keeping its name, transform, policy and kind
+    ///discrete parameters keep the integers within [min, max], but at least min
+    void set_range(size_t index, T min, T max) {
+        auto const& old = optBoundaries.at(schema->name(index));
+
+        if (old.kind != OptKind::CONTINUOUS) {
+            min = ceil(min);
+            max = std::max(floor(max), min);
+        }
+
+        OptBoundary<T> boundary{min, max, old.name, old.transform, old.policy, old.kind};
+
+        optBoundaries.erase(boundary.name);
+        optBoundaries.emplace(boundary.name, boundary);
+        set_index(index, boundary);
+
+        if (hasConditions)
+            resolve_conditions();
+    }
+    //------------------------------------------------------------------------------
+
+    ///number of parameters to loop over via index, known at compile time if N is fixed
+    size_t dimensions() const {
+        return mins.size();
+    }
+
+    //------------------------------------------------------------------------------
+
+    T min(size_t index) const {
+        return mins[index];
+    }
+
+    //------------------------------------------------------------------------------
+
+    T max(size_t index) const {
+        return maxs[index];
+    }
+
+    //------------------------------------------------------------------------------
+
+    T range(size_t index) const {
+        return ranges[index];
+    }
+
+    //------------------------------------------------------------------------------
+
+    T inv_range(size_t index) const {
+        return invRanges[index];
+    }
+
+    //------------------------------------------------------------------------------
+
+    OptBoundaryPolicy policy(size_t index) const {
+        return policies[index];
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///whether proposals leaving the boundaries in any dimension are drawn again
+    bool all_reject() const {
+        return allReject;
+    }
+
+    //------------------------------------------------------------------------------
+
+    OptKind kind(size_t index) const {
+        return kinds[index];
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///number of values of a discrete parameter, 0 if it's continuous
+    T levels(size_t index) const {
+        return nLevels[index];
+    }
+
+    //------------------------------------------------------------------------------
+
+    bool all_continuous() const {
+        return allContinuous;
+    }
+
+    //------------------------------------------------------------------------------
+
+    bool all_discrete() const {
+        return allDiscrete;
+    }
+
+    //------------------------------------------------------------------------------
+
+    bool has_conditions() const {
+        return hasConditions;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///the unit value the parameter at index is held at while it's inactive
+    T canonical(size_t index) const {
+        return canonicals[index];
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///whether the parameter at index is active for the unit values of a candidate, i.e. all conditions up to its root hold
+    ///the first condition which fails has an active parent, so this also holds for values deactivate already worked on
+    bool active(T const* unitValues, size_t index) const {
+        for (size_t i = index; parents[i] != noParent; i = parents[i])
+            if (!activeLevels[i][(size_t)level(unitValues[parents[i]], nLevels[parents[i]])])
+                return false;
+        return true;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///euclidean distance of two candidates within the unit cube, only over the parameters active in both
+    T distance(T const* unitValues, T const* other) const {
+        T squareSum(0.0);
+        for (size_t i = 0; i < dimensions(); ++i) {
+            if (hasConditions && (!active(unitValues, i) || !active(other, i)))
+                continue;
+            squareSum += pow(unitValues[i] - other[i], 2);
+        }
+        return sqrt(squareSum);
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///the value of a discrete parameter of n values, counted from 0, which the unit value lies in
+    static T level(T unitValue, T n) {
+        return std::min(std::max(floor(unitValue * n), (T)0), n - 1);
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///the center of the slice of a value of a discrete parameter of n values
+    static T unit_of_level(T level, T n) {
+        return (level + (T)0.5) / n;
+    }
+
+    //------------------------------------------------------------------------------
+
+    //the following kernels work on nCandidates consecutive candidates of dimensions() values each
+    //their inner loops are branchless over the flat arrays, so the compiler can vectorize them
+
+    bool valid(T const* values) const {
+        const size_t d  = dimensions();
+        T const*     lo = mins.data();
+        T const*     hi = maxs.data();
+        size_t       nInvalid{0};
+
+        for (size_t i = 0; i < d; ++i)
+            nInvalid += (values[i] < lo[i]) | (values[i] > hi[i]);
+
+        return nInvalid == 0;
+    }
+
+    //------------------------------------------------------------------------------
+
+    void valid(T const* values, size_t nCandidates, unsigned char* out) const {
+        const size_t d = dimensions();
+        for (size_t c = 0; c < nCandidates; ++c)
+            out[c] = valid(values + c * d);
+    }
+
+    //------------------------------------------------------------------------------
+
+    void clamp(T* values, size_t nCandidates = 1) const {
+        const size_t d  = dimensions();
+        T const*     lo = mins.data();
+        T const*     hi = maxs.data();
+
+        for (size_t c = 0; c < nCandidates; ++c) {
+            T* v = values + c * d;
+            for (size_t i = 0; i < d; ++i)
+                v[i] = std::min(std::max(v[i], lo[i]), hi[i]);
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///maps values within [0, 1] onto the boundaries
+    void scale(T const* unitValues, T* out, size_t nCandidates = 1) const {
+        const size_t d  = dimensions();
+        T const*     lo = mins.data();
+        T const*     r  = ranges.data();
+
+        for (size_t c = 0; c < nCandidates; ++c) {
+            T const* u = unitValues + c * d;
+            T*       o = out + c * d;
+            for (size_t i = 0; i < d; ++i)
+                o[i] = lo[i] + u[i] * r[i];
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///maps values within the boundaries onto [0, 1]
+    void normalize(T const* values, T* out, size_t nCandidates = 1) const {
+        const size_t d    = dimensions();
+        T const*     lo   = mins.data();
+        T const*     invR = invRanges.data();
+
+        for (size_t c = 0; c < nCandidates; ++c) {
+            T const* v = values + c * d;
+            T*       o = out + c * d;
+            for (size_t i = 0; i < d; ++i)
+                o[i] = (v[i] - lo[i]) * invR[i];
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///moves the values of discrete parameters onto the center of their slice and deactivates, so equal configurations are bitwise equal
+    void snap(T* unitValues, size_t nCandidates = 1) const {
+        if (allContinuous)
+            return;
+
+        const size_t d = dimensions();
+        for (size_t c = 0; c < nCandidates; ++c) {
+            T* u = unitValues + c * d;
+            for (size_t i = 0; i < d; ++i)
+                if (kinds[i] != OptKind::CONTINUOUS)
+                    u[i] = unit_of_level(level(u[i], nLevels[i]), nLevels[i]);
+        }
+
+        deactivate(unitValues, nCandidates);
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///sets the inactive parameters onto their canonical value, so they neither move nor tell configurations apart
+    void deactivate(T* unitValues, size_t nCandidates = 1) const {
+        if (!hasConditions)
+            return;
+
+        const size_t d = dimensions();
+        for (size_t c = 0; c < nCandidates; ++c) {
+            T* u = unitValues + c * d;
+            for (size_t i = 0; i < d; ++i)
+                if (parents[i] != noParent && !active(u, i))
+                    u[i] = canonicals[i];
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///maps values of the unit cube the algorithms search in onto the boundaries, applying the transforms
+    ///discrete parameters take the value of the slice the unit value lies in
+    void to_user(T const* unitValues, T* out, size_t nCandidates = 1) const {
+        //rounding of the scaling mustn't leave the boundaries either
+        if (allLinear && allContinuous) {
+            scale(unitValues, out, nCandidates);
+            clamp(out, nCandidates);
+            return;
+        }
+
+        const size_t d = dimensions();
+        for (size_t c = 0; c < nCandidates; ++c) {
+            T const* u = unitValues + c * d;
+            T*       o = out + c * d;
+            for (size_t i = 0; i < d; ++i) {
+                if (kinds[i] != OptKind::CONTINUOUS) {
+                    o[i] = mins[i] + level(u[i], nLevels[i]);
+                    continue;
+                }
+
+                T value = inverse(transforms[i], transformedMins[i] + u[i] * transformedRanges[i]);
+                o[i]    = std::min(std::max(value, std::min(mins[i], maxs[i])), std::max(mins[i], maxs[i]));  //rounding of the transforms mustn't leave the boundaries
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///maps values within the boundaries onto the unit cube, applying the transforms
+    void to_unit(T const* values, T* out, size_t nCandidates = 1) const {
+        if (allLinear && allContinuous)
+            return normalize(values, out, nCandidates);
+
+        const size_t d = dimensions();
+        for (size_t c = 0; c < nCandidates; ++c) {
+            T const* v = values + c * d;
+            T*       o = out + c * d;
+            for (size_t i = 0; i < d; ++i)
+                o[i] = kinds[i] != OptKind::CONTINUOUS
+                           ? unit_of_level(round(v[i] - mins[i]), nLevels[i])
+                           : (forward(transforms[i], v[i]) - transformedMins[i]) * invTransformedRanges[i];
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    OptTransform transform(size_t index) const {
+        return transforms[index];
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///the schema's indices match the iteration order of the boundaries
+    schema_t const& get_schema() const {
+        return schema;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///resolve a parameter name once, to access it via index afterwards
+    size_t index_of(string const& name) const {
+        return schema->index_of(name);
     }
 
     //------------------------------------------------------------------------------
@@ -59,46 +510,50 @@ class OptBoundaries {
     vector<OptBoundaries> split(string const& name, unsigned int times) const {
         vector<OptBoundaries> out;
 
-        T
-            range(0.0),
-            newRange(0.0);
-
-        bool found(false);
-
-        if (times < 1)
+        if (times < 1 || !schema->contains(name))
             return out;  //error case
 
-        for (auto const& boundary : optBoundaries) {
-            if (boundary.first == name) {
-                range = boundary.second.range();
-                found = true;
-            }
+        const size_t index    = schema->index_of(name);
+        const T      newRange = ranges[index] / (T)times;
+
+        for (unsigned int i = 0; i < times; ++i) {
+            out.push_back(*this);
+            out.back().set_range(index, mins[index] + i * newRange, mins[index] + (i + 1) * newRange);
         }
 
-        if (!found)
-            return out;  //error case if name doesn't exist
+        return out;
+    }
 
-        newRange = range / (T)times;
+    //------------------------------------------------------------------------------
 
-        //split
-        for (unsigned int i = 0; i < times; ++i) {
-            OptBoundaries newBoundaries;
-            for (auto const& boundary : optBoundaries) {
-                if (boundary.first == name) {
-                    T
-                        newMin,
-                        newMax;
+    ///partitions the named parameters into about nCells cells, the others are kept whole
+    ///the cells are split evenly within the unit cube, so transformed parameters are split in their transformed space
+    ///the cells only reference these boundaries, see OptCell
+    vector<OptCell<T, N>> split(vector<string> const& names, size_t nCells, OptSplit optSplit = OptSplit::GRID) const {
+        vector<OptCell<T, N>> out;
 
-                    newMin = boundary.second.min + i * newRange;
-                    newMax = boundary.second.min + (i + 1) * newRange;
+        if (nCells < 1 || names.empty())
+            return out;  //error case
 
-                    OptBoundary<T> newBoundary{newMin, newMax, name};
+        vector<size_t> indices;
+        for (auto const& name : names)
+            indices.push_back(schema->index_of(name));
 
-                    newBoundaries.add_boundary(newBoundary);
-                } else
-                    newBoundaries.add_boundary(boundary.second);
-            }
-            out.push_back(newBoundaries);
+        vector<T>
+            lo(dimensions(), (T)0),
+            hi(dimensions(), (T)1);
+
+        switch (optSplit) {
+            case OptSplit::GRID:
+                split_grid(indices, nCells, lo, hi, out);
+                break;
+
+            case OptSplit::KD:
+                split_kd(indices, nCells, lo, hi, out);
+                break;
+
+            default:  //GRID
+                split_grid(indices, nCells, lo, hi, out);
         }
 
         return out;
@@ -129,6 +584,241 @@ class OptBoundaries {
     }
 
     //------------------------------------------------------------------------------
+
+    ///as split(names, ...), so a braced list of two names isn't mistaken for a single one
+    vector<OptCell<T, N>> split(initializer_list<string> names, size_t nCells, OptSplit optSplit = OptSplit::GRID) const {
+        return split(vector<string>(names), nCells, optSplit);
+    }
+
+    //------------------------------------------------------------------------------
+
+   private:
+    void set_index(size_t i, OptBoundary<T> const& boundary) {
+        mins[i]       = boundary.min;
+        maxs[i]       = boundary.max;
+        ranges[i]     = boundary.range();
+        invRanges[i]  = ranges[i] != 0 ? (T)1 / ranges[i] : (T)0;
+        transforms[i] = boundary.transform;
+        policies[i]   = boundary.policy;
+        kinds[i]      = boundary.kind;
+        nLevels[i]    = boundary.kind != OptKind::CONTINUOUS ? boundary.range() + 1 : (T)0;
+        canonicals[i] = boundary.kind != OptKind::CONTINUOUS ? unit_of_level(level((T)0.5, nLevels[i]), nLevels[i]) : (T)0.5;
+
+        transformedMins[i]      = forward(transforms[i], mins[i]);
+        transformedRanges[i]    = forward(transforms[i], maxs[i]) - transformedMins[i];
+        invTransformedRanges[i] = transformedRanges[i] != 0 ? (T)1 / transformedRanges[i] : (T)0;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///maps the conditions by name onto the current indices and values of the parents
+    ///values outside of the boundaries of the parent never activate
+    void resolve_conditions() {
+        hasConditions = !conditions.empty();
+        activeLevels.assign(dimensions(), {});
+        for (size_t i = 0; i < dimensions(); ++i)
+            parents[i] = noParent;
+
+        for (auto const& condition : conditions) {
+            const size_t
+                i = schema->index_of(condition.first),
+                p = schema->index_of(condition.second.first);
+
+            parents[i] = p;
+            activeLevels[i].assign((size_t)nLevels[p], 0);
+
+            for (auto const& value : condition.second.second) {
+                const T level = round(value - mins[p]);
+                if (level >= 0 && level < nLevels[p])
+                    activeLevels[i][(size_t)level] = 1;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///as many slices per parameter as possible, growing the one with the fewest while the product stays within nCells
+    void split_grid(vector<size_t> const& indices, size_t nCells, vector<T>& lo, vector<T>& hi, vector<OptCell<T, N>>& out) const {
+        vector<size_t> counts(indices.size(), 1);
+        size_t         product{1};
+
+        while (true) {
+            const size_t j    = min_element(counts.begin(), counts.end()) - counts.begin();
+            const size_t next = product / counts[j] * (counts[j] + 1);
+            if (next > nCells)
+                break;
+
+            product = next;
+            ++counts[j];
+        }
+
+        out.reserve(product);
+        for (size_t cell = 0; cell < product; ++cell) {
+            size_t rest = cell;
+            for (size_t j = 0; j < indices.size(); ++j) {
+                const size_t k = rest % counts[j];
+                rest /= counts[j];
+
+                lo[indices[j]] = T(k) / T(counts[j]);
+                hi[indices[j]] = T(k + 1) / T(counts[j]);
+            }
+            out.push_back(cell_of(lo, hi));
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///splits the longest side of the named parameters, with the cells divided between both halves in proportion
+    void split_kd(vector<size_t> const& indices, size_t nCells, vector<T>& lo, vector<T>& hi, vector<OptCell<T, N>>& out) const {
+        if (nCells == 1) {
+            out.push_back(cell_of(lo, hi));
+            return;
+        }
+
+        size_t longest = indices[0];
+        for (auto index : indices)
+            if (hi[index] - lo[index] > hi[longest] - lo[longest])
+                longest = index;
+
+        const size_t nLow = nCells / 2;
+
+        const T
+            oldLo  = lo[longest],
+            oldHi  = hi[longest],
+            middle = oldLo + (oldHi - oldLo) * T(nLow) / T(nCells);
+
+        hi[longest] = middle;
+        split_kd(indices, nLow, lo, hi, out);
+        hi[longest] = oldHi;
+
+        lo[longest] = middle;
+        split_kd(indices, nCells - nLow, lo, hi, out);
+        lo[longest] = oldLo;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///the cell spanning [lo, hi] of the unit cube
+    OptCell<T, N> cell_of(vector<T> const& lo, vector<T> const& hi) const {
+        storage_t<T, N>
+            cellMins{},
+            cellMaxs{};
+
+        if constexpr (N == dynamicSize) {
+            cellMins.resize(dimensions());
+            cellMaxs.resize(dimensions());
+        }
+
+        for (size_t i = 0; i < dimensions(); ++i) {
+            //discrete parameters are split between their values, every cell keeping at least one
+            if (kinds[i] != OptKind::CONTINUOUS) {
+                cellMins[i] = std::min(mins[i] + round(lo[i] * nLevels[i]), maxs[i]);
+                cellMaxs[i] = std::max(mins[i] + round(hi[i] * nLevels[i]) - 1, cellMins[i]);
+                continue;
+            }
+
+            cellMins[i] = lo[i] == (T)0 ? mins[i] : inverse(transforms[i], transformedMins[i] + lo[i] * transformedRanges[i]);
+            cellMaxs[i] = hi[i] == (T)1 ? maxs[i] : inverse(transforms[i], transformedMins[i] + hi[i] * transformedRanges[i]);
+        }
+
+        return OptCell<T, N>(*this, move(cellMins), move(cellMaxs));
+    }
+
+    //------------------------------------------------------------------------------
+
+    static T forward(OptTransform transform, T value) {
+        switch (transform) {
+            case OptTransform::LINEAR:
+                return value;
+
+            case OptTransform::LOG:
+                return log(value);
+
+            case OptTransform::LOGIT:
+                return log(value / (1 - value));
+
+            default:  // LINEAR
+                return value;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    static T inverse(OptTransform transform, T value) {
+        switch (transform) {
+            case OptTransform::LINEAR:
+                return value;
+
+            case OptTransform::LOG:
+                return exp(value);
+
+            case OptTransform::LOGIT:
+                return 1 / (1 + exp(-value));
+
+            default:  // LINEAR
+                return value;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+};
+
+///a cell of a partition of boundaries, only holding its own mins and maxs and referencing the boundaries otherwise
+///valid as long as the boundaries it was split from
+template<typename T, size_t N = dynamicSize>
+class OptCell {
+    OptBoundaries<T, N> const*
+        boundaries;
+
+    storage_t<T, N>  //index aligned with the schema of the boundaries
+        mins,
+        maxs;
+
+    //------------------------------------------------------------------------------
+
+   public:
+    OptCell(OptBoundaries<T, N> const& boundaries, storage_t<T, N> mins, storage_t<T, N> maxs) :
+        boundaries(&boundaries),
+        mins(move(mins)),
+        maxs(move(maxs)) {}
+
+    //------------------------------------------------------------------------------
+
+    T min(size_t index) const {
+        return mins[index];
+    }
+
+    //------------------------------------------------------------------------------
+
+    T max(size_t index) const {
+        return maxs[index];
+    }
+
+    //------------------------------------------------------------------------------
+
+    OptBoundaries<T, N> const& get_boundaries() const {
+        return *boundaries;
+    }
+
+    //------------------------------------------------------------------------------
+
+    bool contains(T const* values) const {
+        size_t nOutside{0};
+        for (size_t i = 0; i < mins.size(); ++i)
+            nOutside += (values[i] < mins[i]) | (values[i] > maxs[i]);
+        return nOutside == 0;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///boundaries of their own, e.g. to pass to an algorithm
+    OptBoundaries<T, N> to_boundaries() const {
+        OptBoundaries<T, N> out(*boundaries);
+        for (size_t i = 0; i < mins.size(); ++i)
+            if (mins[i] != boundaries->min(i) || maxs[i] != boundaries->max(i))
+                out.set_range(i, mins[i], maxs[i]);
+        return out;
+    }
 };
 
 }  // namespace cppOpt
@@ -20,6 +20,29 @@ using namespace std;
 
 namespace cppOpt {
 
+///how a parameter is mapped from the unit interval the algorithms search in onto [min, max]
+enum class OptTransform {
+    LINEAR,
+    LOG,   //requires min and max > 0, for parameters spanning several orders of magnitude
+    LOGIT  //requires 0 < min, max < 1, for parameters close to 0 or 1 such as probabilities
+};
+
+///how proposals leaving [min, max] are brought back, all but REJECT produce a valid proposal in a single pass
+enum class OptBoundaryPolicy {
+    REJECT,   //the whole proposal is drawn again
+    REFLECT,  //mirrored at the boundary
+    CLAMP,    //set onto the boundary
+    WRAP,     //for periodic parameters such as angles, leaving at max enters at min
+    TRUNCATE  //drawn from the part of the neighbourhood within the boundaries
+};
+
+///which values a parameter takes, discrete ones split the unit interval into one slice per value
+enum class OptKind {
+    CONTINUOUS,
+    INTEGER,     //the integers within [min, max]
+    CATEGORICAL  //the indices of the categories within [min, max], which have no order
+};
+
 template<typename T>
 struct OptBoundary {
     const T
@@ -29,6 +52,15 @@ struct OptBoundary {
     const std::string
         name;
 
+    const OptTransform
+        transform{OptTransform::LINEAR};
+
+    const OptBoundaryPolicy
+        policy{OptBoundaryPolicy::REJECT};
+
+    const OptKind
+        kind{OptKind::CONTINUOUS};
+
     //------------------------------------------------------------------------------
 
     T range() const {
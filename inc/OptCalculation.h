@@ -14,43 +14,167 @@
 #ifndef OPTCALCULATION_H
 #define OPTCALCULATION_H
 
+#include <algorithm>
+#include <cmath>
 #include <map>
+#include <stdexcept>
 #include <string>
+#include <vector>
+
+#include "OptParameterSchema.h"
+#include "OptStorage.h"
 
 namespace cppOpt {
 
 using namespace std;
 
-template<typename T>
+template<typename T, size_t N = dynamicSize>
 class OptCalculation {
    private:
-    map<string, T> parameters;
+    schema_t
+        schema;
+
+    storage_t<T, N>
+        values{};
 
    public:
     T result{};
 
     //------------------------------------------------------------------------------
 
-    map<string, T> const& get_parameters() const {
-        return parameters;
+    OptCalculation() = default;
+
+    explicit OptCalculation(schema_t schema) :
+        schema(move(schema)) {
+        if constexpr (N == dynamicSize)
+            values.resize(this->schema ? this->schema->size() : 0);
+        else if (this->schema && this->schema->size() != N)
+            throw runtime_error("The schema doesn't match the fixed number of parameters of the OptCalculation");
+    }
+
+    //------------------------------------------------------------------------------
+
+    schema_t const& get_schema() const {
+        return schema;
+    }
+
+    //------------------------------------------------------------------------------
+
+    size_t size() const {
+        return values.size();
+    }
+
+    //------------------------------------------------------------------------------
+
+    map<string, T> get_parameters() const {
+        map<string, T> out;
+        for (size_t i = 0; i < values.size(); ++i)
+            out.emplace(name(i), values[i]);
+        return out;
     }
 
     //------------------------------------------------------------------------------
 
     void set_parameters(const map<string, T> value) {
-        parameters = move(value);
+        if constexpr (N != dynamicSize) {
+            if (value.size() != N)
+                throw runtime_error("Can't set a different number of parameters than the fixed one of the OptCalculation");
+        } else
+            values.resize(value.size());
+
+        vector<string> names;
+        size_t         i = 0;
+        for (auto const& parameter : value) {
+            names.push_back(parameter.first);
+            values[i++] = parameter.second;
+        }
+        schema = make_shared<const OptParameterSchema>(move(names));
     }
 
     //------------------------------------------------------------------------------
 
+    ///slow path, prefer set_parameter with an index resolved via the schema
     void add_parameter(string const& name, T value) {
-        parameters[name] = value;
+        if (schema && schema->contains(name)) {
+            values[schema->index_of(name)] = value;
+            return;
+        }
+
+        if constexpr (N != dynamicSize)
+            throw runtime_error("Can't add parameters to an OptCalculation with a fixed number of parameters");
+        else {
+            //unknown name, derive a new schema which keeps the names sorted
+            vector<string> names = schema ? schema->get_names() : vector<string>();
+            auto           pos   = lower_bound(names.begin(), names.end(), name) - names.begin();
+
+            names.insert(names.begin() + pos, name);
+            values.insert(values.begin() + pos, value);
+            schema = make_shared<const OptParameterSchema>(move(names));
+        }
     }
 
     //------------------------------------------------------------------------------
 
+    ///slow path, prefer get_parameter with an index resolved via the schema
     T get_parameter(string const& name) const {
-        return parameters.at(name);
+        if (!schema)
+            throw out_of_range("OptCalculation has no parameter named " + name);
+        return values[schema->index_of(name)];
+    }
+
+    //------------------------------------------------------------------------------
+
+    T get_parameter(size_t index) const {
+        return values[index];
+    }
+
+    //------------------------------------------------------------------------------
+
+    void set_parameter(size_t index, T value) {
+        values[index] = value;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///contiguous values, index aligned with the schema
+    T* data() {
+        return values.data();
+    }
+
+    //------------------------------------------------------------------------------
+
+    T const* data() const {
+        return values.data();
+    }
+
+    //------------------------------------------------------------------------------
+
+    template<size_t I>
+    T get() const {
+        static_assert(N == dynamicSize || I < N, "Parameter index out of range");
+        return values[I];
+    }
+
+    //------------------------------------------------------------------------------
+
+    template<typename Tag>
+    T get() const {
+        return get<Tag::index>();
+    }
+
+    //------------------------------------------------------------------------------
+
+    template<size_t I>
+    void set(T value) {
+        static_assert(N == dynamicSize || I < N, "Parameter index out of range");
+        values[I] = value;
+    }
+
+    //------------------------------------------------------------------------------
+
+    template<typename Tag>
+    void set(T value) {
+        set<Tag::index>(value);
     }
 
     //------------------------------------------------------------------------------
@@ -60,8 +184,13 @@ class OptCalculation {
             throw runtime_error("Can't calculate the distance between two OptCalculation if they're not using the same parameters");
 
         T squareSum(0.0);
-        for (auto const& parameter : parameters)
-            squareSum += pow(parameters.at(parameter.first) - other.parameters.at(parameter.first), 2);
+        if (same_layout(other)) {
+            for (size_t i = 0; i < values.size(); ++i)
+                squareSum += pow(values[i] - other.values[i], 2);
+        } else {
+            for (size_t i = 0; i < values.size(); ++i)
+                squareSum += pow(values[i] - other.get_parameter(schema->name(i)), 2);
+        }
 
         return sqrt(squareSum);
     }
@@ -72,11 +201,14 @@ class OptCalculation {
         if (!using_same_parameters(other))
             throw runtime_error("Can't calculate the center of two OptCalculation not having them same parameters");
 
-        OptCalculation out;
+        OptCalculation out(schema);
 
-        for (auto const& parameter : parameters) {
-            T centerValue = (parameters.at(parameter.first) + other.parameters.at(parameter.first)) / 2.0;
-            out.add_parameter(parameter.first, centerValue);
+        if (same_layout(other)) {
+            for (size_t i = 0; i < values.size(); ++i)
+                out.values[i] = (values[i] + other.values[i]) / 2.0;
+        } else {
+            for (size_t i = 0; i < values.size(); ++i)
+                out.values[i] = (values[i] + other.get_parameter(schema->name(i))) / 2.0;
         }
 
         return out;
@@ -85,13 +217,14 @@ class OptCalculation {
     //------------------------------------------------------------------------------
 
     bool using_same_parameters(OptCalculation const& other) const {
-        for (auto const& parameter : parameters) {
-            if (other.parameters.find(parameter.first) == other.parameters.end())
-                return false;
-        }
+        if (same_layout(other))
+            return true;
+
+        if (!schema || !other.schema || values.size() != other.values.size())
+            return false;
 
-        for (auto const& parameter : other.parameters) {
-            if (parameters.find(parameter.first) == parameters.end())
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (!other.schema->contains(schema->name(i)))
                 return false;
         }
         return true;
@@ -102,8 +235,8 @@ class OptCalculation {
     string to_string_values(string const& delimiter = " ") const {
         string out("");
 
-        for (auto const& parameter : parameters)
-            out += to_string(parameter.second) + delimiter;
+        for (auto const& value : values)
+            out += to_string(value) + delimiter;
 
         out += to_string(result);
 
@@ -115,14 +248,30 @@ class OptCalculation {
     string to_string_header(string const& delimiter = " ") const {
         string out("");
 
-        for (auto const& parameter : parameters)
-            out += parameter.first + delimiter;
+        for (size_t i = 0; i < values.size(); ++i)
+            out += name(i) + delimiter;
 
         out += "RESULT";
 
         return out;
     }
 
+    //------------------------------------------------------------------------------
+
+   private:
+    string name(size_t index) const {
+        return schema ? schema->name(index) : std::to_string(index);
+    }
+
+    //------------------------------------------------------------------------------
+
+    bool same_layout(OptCalculation const& other) const {
+        if (schema == other.schema)
+            return true;
+
+        return schema && other.schema && schema->same_as(*other.schema);
+    }
+
     //------------------------------------------------------------------------------
 };
 
@@ -14,21 +14,32 @@
 #ifndef OPTCOORDINATOR_H
 #define OPTCOORDINATOR_H
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <optional>
 #include <queue>
+#include <stdexcept>
 #include <thread>
 #include <type_traits>
+#include <unordered_set>
 #include <vector>
 
 #include "IOptAlgorithm.h"
+#include "IOptDesign.h"
+#include "OptArchive.h"
 #include "OptBoundaries.h"
 #include "OptBoundary.h"
 #include "OptCalculation.h"
 #include "OptHelper.h"
+#include "OptHistory.h"
+#include "OptTaboo.h"
 #include "OptTarget.h"
+#include "OptThreadPool.h"
 #include "OptTypes.h"
 #include "config.h"
 
@@ -38,25 +49,120 @@ using namespace std;
 
 using lock = lock_guard<mutex>;
 
-template<typename T, bool isMultiThreaded = true>
+template<typename T, bool isMultiThreaded = true, size_t N = dynamicSize>
 class OptCoordinator final {
-    using self = OptCoordinator<T, isMultiThreaded>;
+    using self = OptCoordinator<T, isMultiThreaded, N>;
 
-    mutex
-        mTodo,
-        mFinished;
+   public:
+    ///creates a child searching within the given boundaries
+    using spawn_t = function<unique_ptr<IOptAlgorithm<T, N>>(OptBoundaries<T, N> const&)>;
+
+    ///whether a candidate, given in terms of the parameters, may be evaluated
+    ///it may repair the candidate by changing its parameters instead
+    using feasible_t = function<bool(OptCalculation<T, N>&)>;
+
+   private:
+    ///combines the hashes of all values, for sets of candidates
+    struct ValuesHash {
+        size_t operator()(vector<T> const& values) const {
+            size_t out = values.size();
+            for (auto const& value : values)
+                out ^= hash<T>()(value) + 0x9e3779b9 + (out << 6) + (out >> 2);
+            return out;
+        }
+    };
+
+    ///a candidate of a child and its position within the batch of the child
+    struct Todo {
+        OptCalculation<T, N>
+            calculation;
+
+        size_t
+            childId,
+            index;
+    };
+
+    ///state of a single worker, aligned to not share cache lines with the other workers
+    struct alignas(cacheLineSize) Worker {
+        OptCalculation<T, N>  //reused to pass the calculation mapped onto the boundaries to calcFunction
+            userCalculation;
+
+        OptHistory<T, N>  //finished calculations not passed to the archive yet, so the archive is only locked once per archiveBatch of them
+            archived;
+    };
+
+    ///state of a single child, indexed by its id and aligned to not share cache lines with the other children
+    ///only accessed by the worker currently driving the child, the mutex is only needed while several of its candidates are in flight
+    struct alignas(cacheLineSize) ChildState {
+        mutex
+            mChild;
+
+        IOptAlgorithm<T, N>*  //one of children or a spawned one
+            algorithm{nullptr};
+
+        unique_ptr<IOptAlgorithm<T, N>>  //owns the children spawned during the run
+            spawned;
 
-    queue<pair<OptCalculation<T>, IOptAlgorithm<T>*>>
-        queueTodo;
+        OptCalculation<T, N>
+            best;
 
-    vector<OptCalculation<T>>
-        finishedCalculations;
+        OptRandom  //keyed by the seed of the coordinator and the id of the child, positioned at the evaluation index before every ask
+            random;
 
-    vector<unique_ptr<IOptAlgorithm<T>>>
+        size_t
+            nAsked{0},
+            nFinished{0},
+            nInFlight{0},
+            budget{0};
+
+        bool  //the candidates in flight are the latin hypercube of the warm-up
+            warmingUp{false},
+            split{false};  //its region was partitioned already
+
+        //published for the partitioning, which reads them from other threads
+        atomic<T>
+            publishedBest{};
+
+        atomic<size_t>
+            publishedFinished{0};
+
+        atomic<bool>
+            active{true},
+            retire{false};  //requested by the partitioning, the child stops at its next commit
+
+        vector<OptCalculation<T, N>>  //the child is only asked again once the results of all candidates are known
+            candidates,
+            results;  //in the order of the candidates
+
+        unordered_set<vector<T>, ValuesHash>  //the unit values of every candidate, only if all parameters are discrete
+            evaluated;
+    };
+
+    vector<Worker>
+        workers;
+
+    vector<ChildState>
+        childStates;
+
+    size_t
+        maxCalculationsChild{0},
+        candidatesPerChild{0},  //0 to choose by the number of threads
+        batchSize{1},
+        warmUpPoints{0},
+        warmUpPointsChild{0};
+
+    size_t  //guarded by mArchive
+        nextSequenceNumber{0};
+
+    static constexpr size_t
+        archiveBatch{64};
+
+    vector<unique_ptr<IOptAlgorithm<T, N>>>
         children;
 
     bool
-        abortEarly{false};
+        abortEarly{false},
+        deterministic{false};
 
     T
         abortValue{0};
@@ -64,7 +170,7 @@ class OptCoordinator final {
     unsigned int
         randomSeed{(unsigned int)time(NULL)};
 
-    const calc_t<T>
+    const calc_t<T, N>
         calcFunction;
 
     const OptTarget
@@ -73,11 +179,58 @@ class OptCoordinator final {
     const T
         targetValue;
 
-    map<IOptAlgorithm<T>*, std::vector<OptCalculation<T>>>
-        previousCalculations;  ///@todo use vector with child indices?
+    OptArchive<T, N>  //not used for NONE, the best calculations are tracked per child
+        archive;
+
+    mutex
+        mArchive;
+
+    unique_ptr<IOptDesign>  //the start points of the children, independently random if not set
+        initialDesign;
+
+    spawn_t  //empty if the regions aren't partitioned adaptively
+        spawnChild;
+
+    size_t
+        partitionInterval{0},
+        maxChildren{0},
+        nSlots{0};  //children in use within childStates, guarded by mPartition during the run
+
+    conditional_t<isMultiThreaded, atomic<size_t>, size_t>
+        nFinishedTotal{0},
+        freedBudget{0};  //given back by retired children, for spawning new ones
+
+    vector<T>  //of the box spanning the regions of all initial children, the partitioning halves regions along the parameter they are widest in relative to it
+        rootRanges;
+
+    mutex
+        mPartition;
+
+    unique_ptr<OptTaboo<T, N>>  //candidates are never evaluated within its regions
+        taboo;
+
+    bool
+        autoTaboo{false};
+
+    T
+        tabooThreshold{0},
+        tabooRadius{0};
+
+    feasible_t  //empty if every candidate is feasible
+        feasible;
 
-    map<IOptAlgorithm<T>*, OptCalculation<T>>
-        bestCalculations;  ///@todo use vector with child indices?
+    static constexpr size_t
+        maxTries{100};  //to replace a taboo or infeasible candidate, before it's dropped
+
+    conditional_t<isMultiThreaded, atomic<size_t>, size_t>
+        nTabooSkips{0},
+        nChecked{0},
+        nInfeasible{0},
+        nRepaired{0},
+        nDuplicates{0};
+
+    shared_mutex
+        mTaboo;
 
     const unsigned int
         maxCalculations;  ///@todo can be dropped here / stored globally?
@@ -87,18 +240,19 @@ class OptCoordinator final {
    public:
     OptCoordinator(
         unsigned int maxCalculations,
-        calc_t<T>    calcFunction,
+        calc_t<T, N> calcFunction,
         OptTarget    optTarget,
         T            targetValue) :
 
                          calcFunction(move(calcFunction)),
                          optTarget(move(optTarget)),
-                         targetValue(move(targetValue)),
+                         targetValue(targetValue),
+                         archive(OptArchivePolicy::NONE, optTarget, targetValue),
                          maxCalculations(maxCalculations) {}
 
     //------------------------------------------------------------------------------
 
-    void add_child(unique_ptr<IOptAlgorithm<T>> child) {
+    void add_child(unique_ptr<IOptAlgorithm<T, N>> child) {
         children.push_back(move(child));
     }
 
@@ -110,6 +264,14 @@ class OptCoordinator final {
 
     //------------------------------------------------------------------------------
 
+    ///number of candidates every child is asked for at once, which are then evaluated in parallel
+    ///by default enough to keep all threads busy, one if single threaded or deterministic
+    void set_candidates_per_child(size_t n) {
+        candidatesPerChild = n;
+    }
+
+    //------------------------------------------------------------------------------
+
     template<bool b = !isMultiThreaded>
     typename std::enable_if_t<b>
     run_optimisation() {
@@ -124,6 +286,97 @@ class OptCoordinator final {
 
     //------------------------------------------------------------------------------
 
+    ///keeps the finished calculations according to the policy, see OptArchive
+    void set_archive(OptArchivePolicy policy, size_t capacity = 0, string const& path = "") {
+        archive = OptArchive<T, N>(policy, optTarget, targetValue, capacity, path);
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///every worker passes its calculations on in blocks of archiveBatch, the rest once the run finished
+    ///so their order only matches the order they were finished in within a single thread
+    OptArchive<T, N> const& get_archive() const {
+        return archive;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///start points of the children are taken from the design, e.g. OptSobol or OptHalton
+    ///the children take turns, child i of n getting the points i, i + n, i + 2n, ... so they cover the space together
+    void set_initial_design(unique_ptr<IOptDesign> design) {
+        initialDesign = move(design);
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///candidates within the regions are never evaluated, the child is asked for another one instead
+    ///the regions may be declared for the whole search space, the boundaries of the children must share its parameters
+    void set_taboo(unique_ptr<OptTaboo<T, N>> regions) {
+        taboo = move(regions);
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///declares a taboo region of the radius around every result worse than the threshold, requires set_taboo
+    ///multi threaded, the regions declared depend on the order the results come in, so such runs aren't deterministic
+    void enable_auto_taboo(T threshold, T radius) {
+        autoTaboo      = true;
+        tabooThreshold = threshold;
+        tabooRadius    = radius;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///number of candidates which were replaced or dropped during the last run, since they were within a taboo region
+    size_t get_number_of_taboo_skips() const {
+        return nTabooSkips;
+    }
+
+    //------------------------------------------------------------------------------
+
+    OptTaboo<T, N> const* get_taboo() const {
+        return taboo.get();
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///checks every candidate on the thread which asked the child for it, before it's queued
+    ///infeasible candidates are replaced by asking the child again, just as taboo ones. The check has to be thread safe
+    ///candidates changed by the check are kept within the boundaries
+    void set_feasibility(feasible_t check) {
+        feasible = move(check);
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///how many of the candidates checked during the last run were infeasible, see set_feasibility
+    OptRetryCounter get_infeasible() const {
+        OptRetryCounter out;
+        out.nProposals = nChecked;
+        out.nRetries   = nInfeasible;
+        return out;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///number of candidates the feasibility check changed during the last run
+    size_t get_number_of_repairs() const {
+        return nRepaired;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///number of candidates during the last run which a child had evaluated already
+    ///only boundaries whose parameters are all discrete are checked for duplicates, see OptKind
+    ///any continuous parameter makes nearly every candidate unique, so those aren't remembered at all
+    size_t get_number_of_duplicates() const {
+        return nDuplicates;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///a child stops once one of its results reaches the value, the others carry on
+    ///so how far they got doesn't depend on the order the threads finish in
     void enable_early_abort(T const& abortVal) {
         abortEarly = true;
         abortValue = abortVal;
@@ -131,19 +384,72 @@ class OptCoordinator final {
 
     //------------------------------------------------------------------------------
 
-    OptCalculation<T> get_best_calculation() {
-        OptCalculation<T> out;  ///@todo bad value instead (or fail?)
+    ///results independent of the number of threads and bitwise identical to the single threaded coordinator with the same seed
+    ///the number of candidates per child no longer depends on the number of threads
+    void enable_deterministic() {
+        deterministic = true;
+    }
 
-        if (finishedCalculations.size() == 0)
-            return out;
+    //------------------------------------------------------------------------------
 
-        out = finishedCalculations[0];
+    ///evaluates a latin hypercube of nPoints, split between the children, before asking the children for the first time
+    ///all of them are evaluated at once, so the first wave keeps every thread busy
+    ///every child is then told the points of its share, the best one last, which algorithms continue from
+    void enable_warm_up(size_t nPoints) {
+        warmUpPoints = nPoints;
+    }
 
-        for (auto const& finishedCalculation : finishedCalculations)
-            if (OptHelper<T>::result_better(finishedCalculation, out, optTarget, targetValue))
-                out = finishedCalculation;
+    //------------------------------------------------------------------------------
 
-        return out;
+    ///retires children whose region is clearly inferior during the run and spends their budget on new children within the best regions
+    ///every interval finished calculations the children are ranked by their best results
+    ///those of the worst quarter are retired if they lag behind the median by more than the median lags behind the best
+    ///the best region which wasn't partitioned yet is then halved along the parameter it is widest in relative to the regions of the initial children, spawning a child for either half
+    ///at most maxChildren children exist in total, the run isn't deterministic when multi threaded
+    void enable_adaptive_partitioning(spawn_t spawn, size_t interval, size_t maxChildren) {
+        spawnChild        = move(spawn);
+        partitionInterval = std::max<size_t>(interval, 1);
+        this->maxChildren = maxChildren;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///including the ones spawned during the last run
+    size_t get_number_of_children() const {
+        return std::max(nSlots, children.size());
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///the one the archive tracked, unless deterministic, where ties are broken by the child independent of the order the results came in
+    ///a calculation without parameters if nothing was calculated yet
+    OptCalculation<T, N> get_best_calculation() const {
+        if (!deterministic && archive.get_best())
+            return *archive.get_best();
+
+        optional<size_t> best{nullopt};  // CHILD_ID
+
+        for (size_t childId = 0; childId < nSlots; ++childId) {
+            auto const& state = childStates[childId];
+            if (state.nFinished == 0)
+                continue;
+
+            if (!best) {
+                best = childId;
+                continue;
+            }
+
+            auto const& bestState = childStates[*best];
+
+            //on equal results prefer the child with the smaller id, independent of the order they ran in
+            if (OptHelper<T, N>::result_better(state.best, bestState.best, optTarget, targetValue))
+                best = childId;
+        }
+
+        if (!best)
+            return OptCalculation<T, N>();
+
+        return OptHelper<T, N>::to_user(childStates[*best].best, childStates[*best].algorithm->get_boundaries());
     }
 
     //------------------------------------------------------------------------------
@@ -153,144 +459,448 @@ class OptCoordinator final {
         if (children.empty())
             return;
 
-        srand(randomSeed);
+        const size_t nChildren = children.size();
+
+        //the budget is split evenly between the children
+        maxCalculationsChild = std::min<size_t>(maxCalculations, maxCalculations / nChildren + 1);
 
-        //get the first to-calculate value of every optimiser
-        //and push it onto the todo queue
-        for (auto const& child : children) {
-            bestCalculations[child.get()] = random_calculation(child->get_boundaries());
-            push_todo(child->get_next_calculation(previousCalculations[child.get()], &bestCalculations[child.get()]), child.get());
+        if (candidatesPerChild > 0)
+            batchSize = candidatesPerChild;
+        else if (isMultiThreaded && !deterministic)
+            batchSize = (std::max(maxThreads, 1u) + nChildren - 1) / nChildren;
+        else
+            batchSize = 1;
+
+        if (initialDesign)
+            for (auto const& child : children)
+                if (child->get_boundaries().dimensions() > initialDesign->max_dimensions())
+                    throw runtime_error("The initial design supports fewer dimensions than the children have");
+
+        if (autoTaboo && !taboo)
+            throw runtime_error("Automatic taboo regions require set_taboo");
+
+        if (taboo)
+            for (auto const& child : children)
+                if (child->get_boundaries().dimensions() != taboo->get_boundaries().dimensions())
+                    throw runtime_error("The taboo regions have a different number of parameters than the children");
+
+        nTabooSkips = 0;
+        nChecked    = 0;
+        nInfeasible = 0;
+        nRepaired   = 0;
+        nDuplicates = 0;
+
+        warmUpPointsChild = warmUpPoints > 0 ? std::min(maxCalculationsChild, (warmUpPoints + nChildren - 1) / nChildren) : 0;
+
+        //spawned children take the slots behind the initial ones, so the states never move during the run
+        childStates    = vector<ChildState>(spawnChild ? std::max(maxChildren, nChildren) : nChildren);
+        nSlots         = nChildren;
+        nFinishedTotal = 0;
+        freedBudget    = 0;
+
+        if (spawnChild) {
+            auto const& first = children.front()->get_boundaries();
+            vector<T>   mins(first.dimensions()), maxs(first.dimensions());
+            for (size_t i = 0; i < first.dimensions(); ++i) {
+                mins[i] = first.min(i);
+                maxs[i] = first.max(i);
+            }
+
+            for (auto const& child : children)
+                for (size_t i = 0; i < mins.size(); ++i) {
+                    mins[i] = std::min(mins[i], child->get_boundaries().min(i));
+                    maxs[i] = std::max(maxs[i], child->get_boundaries().max(i));
+                }
+
+            rootRanges.resize(mins.size());
+            for (size_t i = 0; i < mins.size(); ++i)
+                rootRanges[i] = maxs[i] - mins[i];
         }
 
+        OptThreadPool<Todo> pool(isMultiThreaded ? maxThreads : 1, childStates.size() * std::max(batchSize, warmUpPointsChild));
+        workers = vector<Worker>(pool.size());
+
+        //get the first candidates of every optimiser
+        //and distribute them between the workers
+        size_t nPushed{0};
+        for (size_t i = 0; i < nChildren; ++i) {
+            auto& state     = childStates[i];
+            state.algorithm = children[i].get();
+            state.budget    = maxCalculationsChild;
+            state.random    = OptRandom(randomSeed, i);
+            if (initialDesign)
+                state.random.use_design(initialDesign.get(), i, nChildren);
+
+            if (warmUpPointsChild > 0)
+                start_warm_up(i);
+            else
+                ask_batch(i);
+
+            for (size_t k = 0; k < state.candidates.size(); ++k)
+                pool.push(nPushed++, Todo{move(state.candidates[k]), i, k});
+            state.candidates.clear();
+        }
+
+        auto work = [this, &pool](size_t worker, Todo&& todo) { return do_work(pool, worker, move(todo)); };
+
         if
             constexpr(isMultiThreaded) {
-                vector<thread> threads;
-                threads.reserve(maxThreads);
+                pool.run(work);
+            }
+        else
+            pool.work(0, work);
 
-                for (unsigned int i = 0; i < maxThreads; ++i)
-                    threads.emplace_back([this]() { return do_work(); });
+        for (auto& worker : workers)
+            flush_archive(worker);
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///passes the calculations buffered by the worker on to the archive, in the order it finished them
+    void flush_archive(Worker& worker) {
+        if (worker.archived.empty())
+            return;
+
+        optional<lock> lck{nullopt};
+        if (isMultiThreaded)
+            lck.emplace(mArchive);
+
+        for (size_t i = 0; i < worker.archived.size(); ++i)
+            archive.add(worker.archived[i], worker.archived.get_child_ids()[i], nextSequenceNumber++);
+
+        worker.archived.clear();
+    }
 
-                for (auto& thread : threads)
-                    thread.join();
+    //------------------------------------------------------------------------------
+
+    ///evaluates a single calculation
+    ///the last one of a batch commits the results, keeps one candidate of the next batch for itself and queues the others
+    optional<Todo> do_work(OptThreadPool<Todo>& pool, size_t workerIndex, Todo&& todo) {
+        auto&        optCalculation = todo.calculation;
+        const size_t childId        = todo.childId;
+        auto&        state          = childStates[childId];
+        auto         algo           = state.algorithm;
+        auto&        worker         = workers[workerIndex];
+
+        OptHelper<T, N>::to_user(optCalculation, algo->get_boundaries(), worker.userCalculation);
+        calcFunction(worker.userCalculation);
+        optCalculation.result = worker.userCalculation.result;
+
+        if (archive.get_policy() != OptArchivePolicy::NONE) {
+            worker.archived.push_back(worker.userCalculation, childId);
+            if (worker.archived.size() >= archiveBatch)
+                flush_archive(worker);
+        }
+
+        //with a single candidate in flight, the child is only ever touched by the worker evaluating it
+        //batches and the warm-up have several, the size of the results only changes once all of them are done
+        optional<lock> lck{nullopt};
+        if (isMultiThreaded && state.results.size() > 1)
+            lck.emplace(state.mChild);
+
+        state.results[todo.index] = move(optCalculation);
+
+        if (--state.nInFlight > 0)
+            return nullopt;
+
+        if (commit_results(childId)) {
+            state.active = false;
+            return nullopt;
+        }
+
+        if (spawnChild) {
+            if (state.retire) {
+                freedBudget += state.budget - state.nFinished;
+                state.budget = state.nFinished;
             }
-        else
-            do_work();  ///@todo rename function
+
+            const size_t nBefore = add_finished(state.results.size());
+            if (nBefore / partitionInterval != (nBefore + state.results.size()) / partitionInterval)
+                partition(pool, workerIndex);
+        }
+
+        if (state.nFinished >= state.budget) {
+            state.active = false;
+            return nullopt;
+        }
+
+        ask_batch(childId);
+
+        if (state.candidates.empty()) {
+            state.active = false;
+            return nullopt;
+        }
+
+        for (size_t k = 1; k < state.candidates.size(); ++k)
+            pool.push(workerIndex, Todo{move(state.candidates[k]), childId, k});
+
+        Todo next{move(state.candidates.front()), childId, 0};
+        state.candidates.clear();
+        return next;
     }
 
     //------------------------------------------------------------------------------
 
-    inline optional<lock> lock_for(mutex& m) {
+    ///returns the number of calculations finished before
+    size_t add_finished(size_t n) {
         if
             constexpr(isMultiThreaded) {
-                return make_optional<lock>(m);
+                return nFinishedTotal.fetch_add(n, memory_order_relaxed);
             }
-        else
-            return nullopt;
+        else {
+            size_t out = nFinishedTotal;
+            nFinishedTotal += n;
+            return out;
+        }
     }
 
     //------------------------------------------------------------------------------
 
-    void do_work() {
-        optional<pair<OptCalculation<T>, IOptAlgorithm<T>*>> todo{nullopt};
+    ///ranks the children by their published best results, retires those of the worst quarter still running which are clearly inferior and halves the best region not partitioned yet
+    ///only a single worker partitions at a time, the others carry on instead of waiting for it
+    void partition(OptThreadPool<Todo>& pool, size_t workerIndex) {
+        unique_lock<mutex> lck(mPartition, try_to_lock);
+        if (!lck.owns_lock())
+            return;
 
-        const auto nChildren = children.size();
-        size_t     calculationsChild{0};
+        //children are only ranked once they had a tenth of the budget of an initial child
+        const size_t minFinished = std::max<size_t>(maxCalculationsChild / 10, 1);
 
-        while (true) {
-            if (!todo || calculationsChild > maxCalculations / nChildren) {
-                calculationsChild = 0;
-                auto lck          = lock_for(mTodo);
-                if (available_todo())
-                    todo = pop_todo();
-                else
-                    break;
-            }
+        vector<pair<T, size_t>> ranked;  // <SORT_VALUE OF THE BEST, CHILD_ID>
+        for (size_t childId = 0; childId < nSlots; ++childId) {
+            auto const& state = childStates[childId];
+            if (!state.retire && state.publishedFinished.load(memory_order_relaxed) >= minFinished)
+                ranked.emplace_back(OptHelper<T, N>::sort_value(state.publishedBest.load(memory_order_relaxed), optTarget, targetValue), childId);
+        }
+
+        if (ranked.empty())
+            return;
 
-            auto[optCalculation, algo] = todo.value();
+        stable_sort(ranked.begin(), ranked.end(), [](pair<T, size_t> const& a, pair<T, size_t> const& b) {
+            return a.first < b.first;
+        });
 
-            calcFunction(optCalculation);
+        //only clearly inferior ones, lagging behind the median by more than the median lags behind the best
+        //their unused budget is freed once they commit their next batch
+        const T
+            best   = ranked.front().first,
+            median = ranked[ranked.size() / 2].first;
 
-            {
-                auto lck = lock_for(mFinished);
-                finishedCalculations.push_back(optCalculation);
+        for (size_t k = ranked.size() - ranked.size() / 4; k < ranked.size(); ++k)
+            if (ranked[k].first - median > median - best && childStates[ranked[k].second].active)
+                childStates[ranked[k].second].retire = true;
+
+        const size_t budget = freedBudget;
+        if (budget < 2 * minFinished || nSlots + 2 > childStates.size())
+            return;
+
+        auto region = find_if(ranked.begin(), ranked.end(), [this](pair<T, size_t> const& r) { return !childStates[r.second].split; });
+        if (region == ranked.end())
+            return;
+
+        auto& parent = childStates[region->second];
+        parent.split = true;
+
+        //every region spans its own unit cube, so its longest side there would always be the first parameter
+        auto const& boundaries = parent.algorithm->get_boundaries();
+        size_t      axis{boundaries.dimensions()};
+        T           widest{0};
+        for (size_t i = 0; i < boundaries.dimensions(); ++i) {
+            const T relative = rootRanges[i] > 0 ? boundaries.range(i) / rootRanges[i] : (T)0;
+            if (relative > widest) {
+                widest = relative;
+                axis   = i;
             }
+        }
 
-            previousCalculations[algo].push_back(optCalculation);
+        if (axis == boundaries.dimensions())
+            return;
 
-            if (OptHelper<T>::result_better(optCalculation, bestCalculations[algo], optTarget, targetValue))
-                bestCalculations[algo] = optCalculation;
+        freedBudget -= budget;
+        auto cells = boundaries.split({boundaries.get_schema()->get_names()[axis]}, 2, OptSplit::KD);
 
-            if (previousCalculations[algo].size() >= maxCalculations)
-                break;
+        for (size_t i = 0; i < cells.size(); ++i) {
+            const size_t childId = nSlots++;
+            auto&        state   = childStates[childId];
 
-            if (abortEarly) {
-                OptCalculation<T> calcEarly;
-                calcEarly.result = abortValue;
+            state.spawned   = spawnChild(cells[i].to_boundaries());
+            state.algorithm = state.spawned.get();
+            state.budget    = budget / cells.size() + (i == 0 ? budget % cells.size() : 0);
+            state.random    = OptRandom(randomSeed, childId);
 
-                if (OptHelper<T>::result_better(optCalculation, calcEarly, optTarget, targetValue))
-                    break;
-            }
+            ask_batch(childId);
 
-            todo = make_pair(
-                algo->get_next_calculation(previousCalculations[algo], &(bestCalculations[algo])),
-                algo);
+            //the child might already be asked again by the worker taking its first candidate
+            auto candidates = move(state.candidates);
+            state.candidates.clear();
 
-            ++calculationsChild;
+            for (size_t k = 0; k < candidates.size(); ++k)
+                pool.push(workerIndex, Todo{move(candidates[k]), childId, k});
         }
     }
 
     //------------------------------------------------------------------------------
 
-    void push_todo(OptCalculation<T> const& optCalculation, IOptAlgorithm<T>* algo) {
-        queueTodo.emplace(make_pair(optCalculation, algo));
+    ///the random numbers of the child are positioned at the index of the evaluation of the first candidate
+    void ask_batch(size_t childId) {
+        auto& state = childStates[childId];
+
+        state.random.seek(state.nAsked);
+        state.algorithm->ask(std::min(batchSize, state.budget - state.nFinished), state.nFinished > 0 ? &state.best : nullptr, state.random, state.candidates);
+        state.nAsked += state.candidates.size();
+
+        if (taboo || feasible || !state.algorithm->get_boundaries().all_continuous())
+            filter_candidates(state);
+
+        start_batch(state);
     }
 
     //------------------------------------------------------------------------------
 
-    bool available_todo() {
-        return !queueTodo.empty();
+    ///the latin hypercube uses the random numbers of the first evaluation, the following asks continue behind it
+    void start_warm_up(size_t childId) {
+        auto& state = childStates[childId];
+
+        state.random.seek(state.nAsked);
+        OptHelper<T, N>::latin_hypercube(state.algorithm->get_boundaries(), warmUpPointsChild, state.random, state.candidates);
+        state.nAsked += state.candidates.size();
+
+        if (taboo || feasible || !state.algorithm->get_boundaries().all_continuous())
+            filter_candidates(state);
+
+        state.warmingUp = true;
+        start_batch(state);
     }
 
     //------------------------------------------------------------------------------
 
-    pair<OptCalculation<T>, IOptAlgorithm<T>*> pop_todo() {
-        auto out = queueTodo.front();
-        queueTodo.pop();
-        return out;
+    ///replaces taboo, infeasible or duplicate candidates by asking the child again, every replacement with the random numbers of an evaluation of its own
+    ///candidates still rejected after maxTries, or which the child has no replacement for, are dropped
+    void filter_candidates(ChildState& state) {
+        optional<shared_lock<shared_mutex>> lck{nullopt};
+        if (isMultiThreaded && taboo)
+            lck.emplace(mTaboo);
+
+        auto const&                  boundaries = state.algorithm->get_boundaries();
+        vector<OptCalculation<T, N>> replacement;
+        OptCalculation<T, N>         user, original;
+        size_t                       nKept{0};
+
+        for (size_t k = 0; k < state.candidates.size(); ++k) {
+            auto& candidate = state.candidates[k];
+            bool  keep{true};
+
+            for (size_t tries = 0; keep && !admissible(state, candidate, boundaries, user, original); ++tries) {
+                replacement.clear();
+
+                if (tries < maxTries) {
+                    state.random.seek(state.nAsked++);
+                    state.algorithm->ask_replacement(state.nFinished > 0 ? &state.best : nullptr, state.random, replacement);
+                }
+
+                if (replacement.empty())
+                    keep = false;
+                else
+                    candidate = move(replacement.front());
+            }
+
+            if (keep && nKept++ != k)
+                state.candidates[nKept - 1] = move(candidate);
+        }
+
+        state.candidates.resize(nKept);
     }
 
     //------------------------------------------------------------------------------
 
-    T bad_value() const {
-        switch (optTarget) {
-            case OptTarget::MINIMIZE:
-                return numeric_limits<T>::max();
+    ///whether the candidate is neither taboo, infeasible nor evaluated by the child already
+    ///discrete values are snapped first and the repairs of the feasibility check are written back
+    bool admissible(ChildState& state, OptCalculation<T, N>& candidate, OptBoundaries<T, N> const& boundaries, OptCalculation<T, N>& user, OptCalculation<T, N>& original) {
+        boundaries.snap(candidate.data());
 
-            case OptTarget::MAXIMIZE:
-                return numeric_limits<T>::lowest();
+        if (taboo && taboo->contains(candidate.data(), boundaries)) {
+            ++nTabooSkips;
+            return false;
+        }
 
-            case OptTarget::APPROACH:
-                if (targetValue > 0.0)
-                    return numeric_limits<T>::lowest();
-                else
-                    return numeric_limits<T>::max();
+        if (feasible) {
+            ++nChecked;
+            OptHelper<T, N>::to_user(candidate, boundaries, user);
+            original = user;
 
-            case OptTarget::DIVERGE:
-                return targetValue;
+            if (!feasible(user)) {
+                ++nInfeasible;
+                return false;
+            }
+
+            if (!equal(user.data(), user.data() + user.size(), original.data())) {
+                ++nRepaired;
+                boundaries.clamp(user.data());
+                boundaries.to_unit(user.data(), candidate.data());
+                boundaries.snap(candidate.data());
+
+                //the repair might have moved it into a taboo region
+                if (taboo && taboo->contains(candidate.data(), boundaries)) {
+                    ++nTabooSkips;
+                    return false;
+                }
+            }
+        }
 
-            default:  //MINIMIZE
-                return numeric_limits<T>::max();
+        //candidates in flight count as evaluated, so neither a batch contains duplicates
+        if (boundaries.all_discrete() && !state.evaluated.emplace(candidate.data(), candidate.data() + candidate.size()).second) {
+            ++nDuplicates;
+            return false;
         }
+        return true;
+    }
+
+    //------------------------------------------------------------------------------
+
+    void start_batch(ChildState& state) {
+        state.nInFlight = state.candidates.size();
+        state.results.resize(state.candidates.size());
     }
 
-    OptCalculation<T> random_calculation(OptBoundaries<T> const& optBoundaries) const {
-        OptCalculation<T> optCalculation;
-        optCalculation.result = bad_value();
-        for (auto const& boundary : optBoundaries) {
-            T newValue = boundary.second.min + OptHelper<T>::random_factor() * boundary.second.range();
-            optCalculation.add_parameter(boundary.second.name, newValue);
+    //------------------------------------------------------------------------------
+
+    ///commits the results of a finished batch in the order of its candidates, independent of the order they were calculated in
+    ///returns whether one of them reached the value to abort early
+    bool commit_results(size_t childId) {
+        auto& state = childStates[childId];
+        bool  reached{false};
+
+        //worst first, so algorithms continuing from their last result start at the best point of the warm-up
+        if (state.warmingUp) {
+            stable_sort(state.results.begin(), state.results.end(), [this](OptCalculation<T, N> const& a, OptCalculation<T, N> const& b) {
+                return OptHelper<T, N>::result_better(b, a, optTarget, targetValue);
+            });
+            state.warmingUp = false;
+        }
+
+        optional<unique_lock<shared_mutex>> lckTaboo{nullopt};
+
+        for (auto const& result : state.results) {
+            if (autoTaboo && OptHelper<T, N>::result_better(tabooThreshold, result.result, optTarget, targetValue)) {
+                if (isMultiThreaded && !lckTaboo)
+                    lckTaboo.emplace(mTaboo);
+                taboo->add(result.data(), state.algorithm->get_boundaries(), tabooRadius);
+            }
+
+            if (state.nFinished++ == 0 || OptHelper<T, N>::result_better(result, state.best, optTarget, targetValue))
+                state.best = result;
+
+            if (abortEarly && OptHelper<T, N>::result_better(result.result, abortValue, optTarget, targetValue))
+                reached = true;
+        }
+
+        state.algorithm->tell(state.results);
+
+        if (spawnChild) {
+            state.publishedBest.store(state.best.result, memory_order_relaxed);
+            state.publishedFinished.store(state.nFinished, memory_order_relaxed);
         }
-        return optCalculation;
+        return reached;
     }
 
     //------------------------------------------------------------------------------
@@ -16,13 +16,15 @@
 
 #include "IOptAlgorithm.h"
 
+#include <algorithm>
+#include <queue>
 #include <set>
 
 namespace cppOpt {
 
-template<typename T>
-class OptEvolutionary final : public IOptAlgorithm<T> {
-    OptBoundaries<T>
+template<typename T, size_t N = dynamicSize>
+class OptEvolutionary final : public IOptAlgorithm<T, N> {
+    OptBoundaries<T, N>
         boundaries;
 
     const OptTarget
@@ -43,14 +45,12 @@ class OptEvolutionary final : public IOptAlgorithm<T> {
         mutation,
         chance;
 
-    multimap<T, OptCalculation<T>>  // <SORT_VALUE, CALCULATION>
-        previousCalculationsSorted;
-
-    vector<OptCalculation<T>>
+    vector<OptCalculation<T, N>>
         individualsStart,
-        individualsSelected;
+        individualsSelected,
+        elites;  //the best results so far, best first
 
-    queue<OptCalculation<T>>
+    queue<OptCalculation<T, N>>
         individualsBred,
         individualsMutated;
 
@@ -58,14 +58,14 @@ class OptEvolutionary final : public IOptAlgorithm<T> {
 
    public:
     OptEvolutionary(
-        OptBoundaries<T> boundaries,
-        OptTarget        optTarget,
-        T                targetValue,
-        T                coolingFactor,
-        unsigned int     nIndividualsStart,
-        unsigned int     nIndividualsSelection,
-        unsigned int     nIndividualsOffspring,
-        T                mutation) :
+        OptBoundaries<T, N> boundaries,
+        OptTarget           optTarget,
+        T                   targetValue,
+        T                   coolingFactor,
+        unsigned int        nIndividualsStart,
+        unsigned int        nIndividualsSelection,
+        unsigned int        nIndividualsOffspring,
+        T                   mutation) :
 
                       boundaries(move(boundaries)),
                       optTarget(move(optTarget)),
@@ -78,15 +78,11 @@ class OptEvolutionary final : public IOptAlgorithm<T> {
 
     //------------------------------------------------------------------------------
 
-    OptCalculation<T> get_next_calculation(
-        vector<OptCalculation<T>> const& previous,
-        OptCalculation<T> const*         best) final {
-        if (previous.empty() || !best)
-            create_start_individuals();
-        else
-            add_previous_to_sorted(previous);
+    OptCalculation<T, N> get_next_calculation(OptCalculation<T, N> const* best, OptRandom& random) final {
+        if ((elites.empty() || !best) && individualsStart.empty())
+            create_start_individuals(random);
 
-        OptCalculation<T> out;
+        OptCalculation<T, N> out;
 
         if (individualsStart.size() != 0) {
             out = individualsStart.back();
@@ -100,7 +96,7 @@ class OptEvolutionary final : public IOptAlgorithm<T> {
         if (individualsMutated.size() == 0) {
             select_individuals();
             breed_individuals();
-            mutate_individuals();
+            mutate_individuals(random);
         }
 
         out = individualsMutated.front();
@@ -113,51 +109,84 @@ class OptEvolutionary final : public IOptAlgorithm<T> {
 
     //------------------------------------------------------------------------------
 
-    OptBoundaries<T> const& get_boundaries() final {
-        return boundaries;
+    ///hands out the rest of the current generation, but at most n
+    ///the next generation is only bred once the results of this one are known
+    void ask(
+        size_t                        n,
+        OptCalculation<T, N> const*   best,
+        OptRandom&                    random,
+        vector<OptCalculation<T, N>>& candidates) final {
+        for (size_t i = 0; i < n; ++i) {
+            if (i > 0 && individualsStart.empty() && individualsMutated.empty())
+                break;
+
+            if (i > 0)
+                random.next_evaluation();
+
+            candidates.push_back(get_next_calculation(best, random));
+        }
     }
 
     //------------------------------------------------------------------------------
 
-   private:
-    void add_previous_to_sorted(vector<OptCalculation<T>> const& previous) {
-        if (previous.size() > 0) {
-            T sortValue = calculate_sort_value(previous.back());
-            previousCalculationsSorted.emplace(sortValue, previous.back());
-        }
+    ///only from the rest of the current generation, since the next one needs the results of this one
+    void ask_replacement(
+        OptCalculation<T, N> const*   best,
+        OptRandom&                    random,
+        vector<OptCalculation<T, N>>& candidates) final {
+        if (!individualsStart.empty() || !individualsMutated.empty())
+            candidates.push_back(get_next_calculation(best, random));
     }
 
     //------------------------------------------------------------------------------
 
-    void create_start_individuals() {
-        individualsStart.push_back(OptHelper<T>::random_calculation(boundaries));
+    ///keeps the results which will be selected for breeding
+    void on_result(OptCalculation<T, N> const& result) final {
+        const size_t nElites = max(1u, nIndividualsSelection);
 
-        for (unsigned int i = 1; i < nIndividualsStart; ++i) {
-            OptCalculation<T> optCalculation = OptHelper<T>::random_calculation(boundaries);
-            individualsStart.push_back(optCalculation);
-        }
+        //behind all elites which are at least as good, so older ones are preferred on ties
+        auto position = find_if(elites.begin(), elites.end(), [this, &result](OptCalculation<T, N> const& elite) {
+            return OptHelper<T, N>::result_better(result, elite, optTarget, targetValue);
+        });
+
+        if ((size_t)(position - elites.begin()) >= nElites)
+            return;
+
+        elites.insert(position, result);
+        if (elites.size() > nElites)
+            elites.pop_back();
     }
 
     //------------------------------------------------------------------------------
 
-    void select_individuals() {
-        unsigned int i = 1;
+    OptBoundaries<T, N> const& get_boundaries() final {
+        return boundaries;
+    }
 
-        for (auto const& individual : previousCalculationsSorted) {
-            individualsSelected.push_back(individual.second);
+    //------------------------------------------------------------------------------
 
-            if (i >= nIndividualsSelection)
-                break;
+   private:
+    void create_start_individuals(OptRandom& random) {
+        individualsStart.push_back(OptHelper<T, N>::random_calculation(boundaries, random));
 
-            ++i;
+        for (unsigned int i = 1; i < nIndividualsStart; ++i) {
+            OptCalculation<T, N> optCalculation = OptHelper<T, N>::random_calculation(boundaries, random);
+            individualsStart.push_back(optCalculation);
         }
     }
 
     //------------------------------------------------------------------------------
 
+    void select_individuals() {
+        for (auto const& elite : elites)
+            individualsSelected.push_back(elite);
+    }
+
+    //------------------------------------------------------------------------------
+
     void breed_individuals() {
         set<unsigned int> usedIndexes;
-        vector<pair<OptCalculation<T>, OptCalculation<T>>> parents;
+        vector<pair<OptCalculation<T, N>, OptCalculation<T, N>>> parents;
 
         for (unsigned int i = 0; i < individualsSelected.size(); ++i) {
             unsigned int indexClosest = index_closest_calculation(individualsSelected, i);
@@ -177,24 +206,12 @@ class OptEvolutionary final : public IOptAlgorithm<T> {
 
     //------------------------------------------------------------------------------
 
-    void mutate_individuals() {
+    void mutate_individuals(OptRandom& random) {
         while (individualsBred.size() != 0) {
             auto individual = individualsBred.front();
             individualsBred.pop();
 
-            OptCalculation<T> mutatedIndividual;
-            for (auto const& boundary : boundaries) {
-                T change, maxChange;
-
-                maxChange = 0.5 * boundary.second.range() * mutation;
-                change    = OptHelper<T>::random_factor() * maxChange;
-
-                if (rand() % 2)
-                    change *= -1.0;
-
-                mutatedIndividual.add_parameter(boundary.second.name, individual.get_parameter(boundary.second.name) + change);
-            }
-            individualsMutated.push(mutatedIndividual);
+            individualsMutated.push(OptHelper<T, N>::random_neighbour(individual, boundaries, mutation, random));
         }
     }
 
@@ -206,28 +223,7 @@ class OptEvolutionary final : public IOptAlgorithm<T> {
 
     //------------------------------------------------------------------------------
 
-    T calculate_sort_value(const OptCalculation<T>& optCalculation) const {
-        switch (optTarget) {
-            case OptTarget::MINIMIZE:
-                return optCalculation.result;
-
-            case OptTarget::MAXIMIZE:
-                return -optCalculation.result;
-
-            case OptTarget::APPROACH:
-                return fabs(targetValue - optCalculation.result);
-
-            case OptTarget::DIVERGE:
-                return -fabs(targetValue - optCalculation.result);
-
-            default:  // MINIMIZE
-                return optCalculation.result;
-        }
-    }
-
-    //------------------------------------------------------------------------------
-
-    unsigned int index_closest_calculation(vector<OptCalculation<T>> const& optCalculations, unsigned int indexThis) const  ///@todo could be moved to some helper, also should be easy to simplify heavily
+    unsigned int index_closest_calculation(vector<OptCalculation<T, N>> const& optCalculations, unsigned int indexThis) const  ///@todo could be moved to some helper, also should be easy to simplify heavily
     {
         T            closestDistance;
         unsigned int indexClosest(0);
@@ -238,11 +234,11 @@ class OptEvolutionary final : public IOptAlgorithm<T> {
                 continue;
 
             if (!initialised) {
-                closestDistance = optCalculations[i].distance_to(optCalculations[indexThis]);
+                closestDistance = boundaries.distance(optCalculations[i].data(), optCalculations[indexThis].data());
                 indexClosest    = i;
                 initialised     = true;
             } else {
-                T distance = optCalculations[i].distance_to(optCalculations[indexThis]);
+                T distance = boundaries.distance(optCalculations[i].data(), optCalculations[indexThis].data());
 
                 if (distance < closestDistance) {
                     closestDistance = distance;
@@ -18,9 +18,9 @@
 
 namespace cppOpt {
 
-template<typename T>
-class OptGreatDeluge final : public IOptAlgorithm<T> {
-    OptBoundaries<T>
+template<typename T, size_t N = dynamicSize>
+class OptGreatDeluge final : public IOptAlgorithm<T, N> {
+    OptBoundaries<T, N>
         boundaries;
 
     const OptTarget
@@ -29,10 +29,16 @@ class OptGreatDeluge final : public IOptAlgorithm<T> {
     const T
         targetValue;
 
-    OptCalculation<T>
+    OptCalculation<T, N>
         optCalculationReference,
         optCalculationConfigurationC;
 
+    optional<OptCalculation<T, N>>
+        last;  //the most recent result
+
+    OptRetryCounter
+        retries;
+
     const T
         coolingFactor,
         rain;
@@ -45,12 +51,12 @@ class OptGreatDeluge final : public IOptAlgorithm<T> {
     //------------------------------------------------------------------------------
 
     OptGreatDeluge(
-        OptBoundaries<T> boundaries,
-        OptTarget        optTarget,
-        T                targetValue,
-        T                coolingFactor,
-        T                waterLevel,
-        T                rain) :
+        OptBoundaries<T, N> boundaries,
+        OptTarget           optTarget,
+        T                   targetValue,
+        T                   coolingFactor,
+        T                   waterLevel,
+        T                   rain) :
 
                   boundaries(move(boundaries)),
                   optTarget(move(optTarget)),
@@ -61,33 +67,22 @@ class OptGreatDeluge final : public IOptAlgorithm<T> {
 
     //------------------------------------------------------------------------------
 
-    OptCalculation<T> get_next_calculation(
-        vector<OptCalculation<T>> const& previous,
-        OptCalculation<T> const*         best) final {
-        if (previous.empty() || !best)
-            return OptHelper<T>::random_calculation(boundaries);
+    OptCalculation<T, N> get_next_calculation(OptCalculation<T, N> const* best, OptRandom& random) final {
+        if (!last || !best)
+            return OptHelper<T, N>::random_calculation(boundaries, random);
 
-        OptCalculation<T>
+        OptCalculation<T, N>
             newValue,
             referenceValue,
             compareValue = compare_value();
 
-        if (OptHelper<T>::result_better(previous.back(), compareValue, optTarget, targetValue))
-            referenceValue = previous.back();
+        if (OptHelper<T, N>::result_better(*last, compareValue, optTarget, targetValue))
+            referenceValue = *last;
 
         else
             referenceValue = *best;
 
-        while (true) {
-            newValue = OptCalculation<T>();
-            for (auto const& boundary : boundaries) {
-                T change = OptHelper<T>::calculate_random_change(boundary.second, temperature);
-
-                newValue.add_parameter(boundary.first, referenceValue.get_parameter(boundary.first) + change);
-            }
-            if (OptHelper<T>::valid(newValue, boundaries))
-                break;
-        }
+        newValue = OptHelper<T, N>::valid_neighbour(referenceValue, boundaries, temperature, random, retries);
 
         update_temperature();
         update_water_level();
@@ -96,12 +91,42 @@ class OptGreatDeluge final : public IOptAlgorithm<T> {
 
     //------------------------------------------------------------------------------
 
-    OptBoundaries<T> const& get_boundaries() final {
+    ///speculative proposals, all of them based on the calculations known so far
+    ///every proposal uses the random numbers of its own evaluation
+    void ask(
+        size_t                        n,
+        OptCalculation<T, N> const*   best,
+        OptRandom&                    random,
+        vector<OptCalculation<T, N>>& candidates) final {
+        for (size_t i = 0; i < n; ++i) {
+            if (i > 0)
+                random.next_evaluation();
+
+            candidates.push_back(get_next_calculation(best, random));
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    void on_result(OptCalculation<T, N> const& result) final {
+        last = result;
+    }
+
+    //------------------------------------------------------------------------------
+
+    OptBoundaries<T, N> const& get_boundaries() final {
         return boundaries;
     }
 
     //------------------------------------------------------------------------------
 
+    ///how often proposals were drawn again, since they left boundaries with OptBoundaryPolicy::REJECT
+    OptRetryCounter const& get_retries() const {
+        return retries;
+    }
+
+    //------------------------------------------------------------------------------
+
    private:
     void update_temperature() {
         temperature *= coolingFactor;
@@ -140,8 +165,8 @@ class OptGreatDeluge final : public IOptAlgorithm<T> {
 
     //------------------------------------------------------------------------------
 
-    OptCalculation<T> compare_value() const {
-        OptCalculation<T> out;
+    OptCalculation<T, N> compare_value() const {
+        OptCalculation<T, N> out;
         out.result = waterLevel;
         return out;
     }
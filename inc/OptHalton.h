@@ -0,0 +1,83 @@
+/*
+    Copyright (c) 2017 Martin Buck
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation the rights to
+    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+    The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+    OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef OPTHALTON_H
+#define OPTHALTON_H
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "IOptDesign.h"
+#include "OptRandom.h"
+
+namespace cppOpt {
+
+using namespace std;
+
+///Halton sequence, the radical inverse of the index in the base of one prime per dimension
+///scrambled by a random shift per dimension (Cranley-Patterson rotation), selected by the seed
+class OptHalton final : public IOptDesign {
+    vector<uint32_t>
+        bases;
+
+    vector<double>
+        shifts;
+
+    //------------------------------------------------------------------------------
+
+   public:
+    explicit OptHalton(uint64_t seed = 0, size_t maxDimensions = 256) {
+        OptRandom random(seed);
+
+        for (uint32_t candidate = 2; bases.size() < maxDimensions; ++candidate) {
+            bool prime = true;
+            for (size_t i = 0; i < bases.size() && bases[i] * bases[i] <= candidate && prime; ++i)
+                prime = candidate % bases[i] != 0;
+
+            if (prime) {
+                bases.push_back(candidate);
+                shifts.push_back(random.uniform<double>());
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    double coordinate(uint64_t index, size_t dimension) const final {
+        if (dimension >= bases.size())
+            throw out_of_range("Halton design has fewer dimensions than requested");
+
+        const uint64_t base = bases[dimension];
+        double         x{0}, factor{1.0 / base};
+
+        for (; index > 0; index /= base, factor /= base)
+            x += (index % base) * factor;
+
+        x += shifts[dimension];
+        return x >= 1.0 ? x - 1.0 : x;
+    }
+
+    //------------------------------------------------------------------------------
+
+    size_t max_dimensions() const final {
+        return bases.size();
+    }
+
+    //------------------------------------------------------------------------------
+};
+
+}  // namespace cppOpt
+
+#endif  // OPTHALTON_H
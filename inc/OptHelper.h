@@ -14,66 +14,141 @@
 #ifndef OPTHELPER_H
 #define OPTHELPER_H
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
 #include "OptBoundaries.h"
+#include "OptCalculation.h"
+#include "OptRandom.h"
 #include "OptTarget.h"
 
 namespace cppOpt {
 
 using namespace std;
 
-template<typename T>
+///proposals which had to be drawn again, since they left the boundaries in a dimension with OptBoundaryPolicy::REJECT
+struct OptRetryCounter {
+    size_t
+        nProposals{0},
+        nRetries{0};
+
+    //------------------------------------------------------------------------------
+
+    ///retries per proposal
+    double rate() const {
+        return nProposals > 0 ? double(nRetries) / nProposals : 0.0;
+    }
+};
+
+template<typename T, size_t N = dynamicSize>
 class OptHelper {
    public:
     //------------------------------------------------------------------------------
 
     //targetValue won't be used when maximizing or minimizing
-    static bool result_better(OptCalculation<T> const& result, OptCalculation<T> const& other, OptTarget const& optTarget, T const& targetValue)  ///@todo consider implementing this in OptCalculation
+    static bool result_better(OptCalculation<T, N> const& result, OptCalculation<T, N> const& other, OptTarget const& optTarget, T const& targetValue)  ///@todo consider implementing this in OptCalculation
     {
+        return result_better(result.result, other.result, optTarget, targetValue);
+    }
+
+    //------------------------------------------------------------------------------
+
+    static bool result_better(T result, T other, OptTarget const& optTarget, T const& targetValue) {
         switch (optTarget) {
             case OptTarget::MINIMIZE:
-                return result.result < other.result;
+                return result < other;
 
             case OptTarget::MAXIMIZE:
-                return result.result > other.result;
+                return result > other;
 
             case OptTarget::APPROACH:
-                return fabs(targetValue - result.result) < fabs(targetValue - other.result);
+                return fabs(targetValue - result) < fabs(targetValue - other);
 
             case OptTarget::DIVERGE:
-                return fabs(targetValue - result.result) > fabs(targetValue - other.result);
+                return fabs(targetValue - result) > fabs(targetValue - other);
 
             default:  //MINIMIZE
-                return result.result < other.result;
+                return result < other;
         }
     }
 
     //------------------------------------------------------------------------------
 
-    static T random_factor()  ///@todo all related functions now defined twice, move to helper
-    {
-        return rand() / (T)(RAND_MAX);
+    ///a value which is smaller the better the result is, as OptHistory::sort_values
+    static T sort_value(T result, OptTarget const& optTarget, T const& targetValue) {
+        switch (optTarget) {
+            case OptTarget::MINIMIZE:
+                return result;
+
+            case OptTarget::MAXIMIZE:
+                return -result;
+
+            case OptTarget::APPROACH:
+                return fabs(targetValue - result);
+
+            case OptTarget::DIVERGE:
+                return -fabs(targetValue - result);
+
+            default:  //MINIMIZE
+                return result;
+        }
     }
 
     //------------------------------------------------------------------------------
 
-    static OptCalculation<T> random_calculation(OptBoundaries<T> const& boundaries) {
-        OptCalculation<T> optCalculation;
-        for (auto const& boundary : boundaries) {
-            T newValue = boundary.second.min + OptHelper<T>::random_factor() * boundary.second.range();
-            optCalculation.add_parameter(boundary.second.name, newValue);
-        }
+    static T random_factor(OptRandom& random) {
+        return random.uniform<T>();
+    }
+
+    //------------------------------------------------------------------------------
+
+    //all algorithms search within the unit cube [0, 1]^d of their boundaries
+    //calculations are only mapped onto the actual boundaries right before they're calculated, see to_user
+
+    ///the next point of the initial design of random, if it uses one
+    static OptCalculation<T, N> random_calculation(OptBoundaries<T, N> const& boundaries, OptRandom& random) {
+        OptCalculation<T, N> optCalculation(boundaries.get_schema());
+        if (!random.next_design_point(optCalculation.data(), boundaries.dimensions()))
+            random.fill_uniform(optCalculation.data(), boundaries.dimensions());
+        boundaries.snap(optCalculation.data());
         return optCalculation;
     }
 
     //------------------------------------------------------------------------------
 
-    static T calculate_random_change(const OptBoundary<T>& boundary, T temperature) {
+    ///appends n points, which have exactly one point in each of the n intervals of every dimension
+    static void latin_hypercube(OptBoundaries<T, N> const& boundaries, size_t n, OptRandom& random, vector<OptCalculation<T, N>>& out) {
+        const size_t first = out.size();
+        for (size_t i = 0; i < n; ++i)
+            out.emplace_back(boundaries.get_schema());
+
+        vector<size_t> intervals(n);
+        for (size_t d = 0; d < boundaries.dimensions(); ++d) {
+            //Fisher-Yates shuffle of the intervals of this dimension
+            for (size_t i = 0; i < n; ++i)
+                intervals[i] = i;
+            for (size_t i = n; i > 1; --i)
+                swap(intervals[i - 1], intervals[random.next() % i]);
+
+            for (size_t i = 0; i < n; ++i)
+                out[first + i].data()[d] = (intervals[i] + random.uniform<T>()) / T(n);
+        }
+
+        for (size_t i = 0; i < n; ++i)
+            boundaries.snap(out[first + i].data());
+    }
+
+    //------------------------------------------------------------------------------
+
+    static T calculate_random_change(T temperature, OptRandom& random) {
         T change, maxChange;
 
-        maxChange = (T)0.5 * boundary.range() * temperature;
-        change    = OptHelper<T>::random_factor() * maxChange;
+        maxChange = (T)0.5 * temperature;
+        change    = OptHelper<T, N>::random_factor(random) * maxChange;
 
-        if (rand() % 2)
+        if (random.coin())
             change *= -1.0;
 
         return change;
@@ -81,12 +156,176 @@ class OptHelper {
 
     //------------------------------------------------------------------------------
 
-    static bool valid(const OptCalculation<T>& optCalculation, OptBoundaries<T> const& boundaries) {
-        for (auto const& boundary : boundaries) {
-            if (optCalculation.get_parameter(boundary.first) < boundary.second.min || optCalculation.get_parameter(boundary.first) > boundary.second.max)
-                return false;
+    //optCalculation has to be created from the schema of boundaries
+    static bool valid(const OptCalculation<T, N>& optCalculation, OptBoundaries<T, N> const& boundaries) {
+        const size_t d = boundaries.dimensions();
+        T const*     u = optCalculation.data();
+        size_t       nInvalid{0};
+
+        for (size_t i = 0; i < d; ++i)
+            nInvalid += (u[i] < (T)0) | (u[i] > (T)1);
+
+        return nInvalid == 0;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///draws the random numbers of all dimensions at once, the same ones as calculate_random_change per dimension would
+    static OptCalculation<T, N> random_neighbour(OptCalculation<T, N> const& reference, OptBoundaries<T, N> const& boundaries, T temperature, OptRandom& random) {
+        const size_t         d = boundaries.dimensions();
+        OptCalculation<T, N> newValue(boundaries.get_schema());
+
+        uint32_t const* words = random.words(3 * d);
+
+        add_random_changes(reference.data(), newValue.data(), d, temperature, words);
+        if (!boundaries.all_reject())
+            apply_boundary_policies(reference.data(), newValue.data(), boundaries, temperature, words);
+        if (!boundaries.all_continuous())
+            apply_discrete_changes(reference.data(), newValue.data(), boundaries, temperature, words);
+        if (boundaries.has_conditions())
+            boundaries.deactivate(newValue.data());
+        return newValue;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///draws neighbours until one is within the boundaries, which takes a single pass unless a dimension rejects
+    static OptCalculation<T, N> valid_neighbour(OptCalculation<T, N> const& reference, OptBoundaries<T, N> const& boundaries, T temperature, OptRandom& random, OptRetryCounter& retries) {
+        ++retries.nProposals;
+
+        while (true) {
+            auto newValue = random_neighbour(reference, boundaries, temperature, random);
+            if (valid(newValue, boundaries))
+                return newValue;
+            ++retries.nRetries;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///brings the dimensions which left the unit interval back according to their policy
+    ///truncated dimensions are drawn again from the words the change was made of
+    static void apply_boundary_policies(T const* reference, T* values, OptBoundaries<T, N> const& boundaries, T temperature, uint32_t const* words) {
+        const T maxChange = (T)0.5 * temperature;
+
+        for (size_t i = 0; i < boundaries.dimensions(); ++i) {
+            switch (boundaries.policy(i)) {
+                case OptBoundaryPolicy::REJECT:
+                    break;
+
+                case OptBoundaryPolicy::REFLECT: {
+                    const T x = fmod(fabs(values[i]), (T)2);
+                    values[i] = x > (T)1 ? (T)2 - x : x;
+                } break;
+
+                case OptBoundaryPolicy::CLAMP:
+                    values[i] = std::min(std::max(values[i], (T)0), (T)1);
+                    break;
+
+                case OptBoundaryPolicy::WRAP:
+                    values[i] -= floor(values[i]);
+                    break;
+
+                case OptBoundaryPolicy::TRUNCATE: {
+                    const T
+                        lo = std::max(reference[i] - maxChange, (T)0),
+                        hi = std::min(reference[i] + maxChange, (T)1);
+
+                    values[i] = lo + OptRandom::to_uniform<T>(words[3 * i], words[3 * i + 1]) * (hi - lo);
+                } break;
+
+                default:  //REJECT
+                    break;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///replaces the changes of discrete dimensions, made of the same words as the continuous ones
+    ///integers move by up to the change of the temperature, but at least one value, and may also stay, so single coordinates can change on their own
+    ///their policy applies to the values
+    ///categories have no order, they switch to any other one with a chance of the temperature
+    static void apply_discrete_changes(T const* reference, T* values, OptBoundaries<T, N> const& boundaries, T temperature, uint32_t const* words) {
+        const T maxChange = (T)0.5 * temperature;
+
+        for (size_t i = 0; i < boundaries.dimensions(); ++i) {
+            if (boundaries.kind(i) == OptKind::CONTINUOUS)
+                continue;
+
+            const T n      = boundaries.levels(i);
+            const T level  = OptBoundaries<T, N>::level(reference[i], n);
+            const T factor = OptRandom::to_uniform<T>(words[3 * i], words[3 * i + 1]);
+            T       next   = level;
+
+            //a single value can't change
+            switch (n > (T)1 ? boundaries.kind(i) : OptKind::CONTINUOUS) {
+                case OptKind::INTEGER: {
+                    const T step = round(factor * std::max(maxChange * n, (T)1));
+                    next         = (words[3 * i + 2] >> 31) ? level - step : level + step;
+
+                    switch (boundaries.policy(i)) {
+                        case OptBoundaryPolicy::REJECT:
+                            break;  //stays outside of the unit interval
+
+                        case OptBoundaryPolicy::REFLECT:
+                            next = fabs(next);
+                            next = fmod(next, 2 * (n - 1));
+                            next = next > n - 1 ? 2 * (n - 1) - next : next;
+                            break;
+
+                        case OptBoundaryPolicy::WRAP:
+                            next -= floor(next / n) * n;
+                            break;
+
+                        default:  //CLAMP, TRUNCATE
+                            next = std::min(std::max(next, (T)0), n - 1);
+                            break;
+                    }
+                } break;
+
+                case OptKind::CATEGORICAL:
+                    if (factor < temperature)
+                        next = fmod(level + 1 + (words[3 * i + 2] & 0x7FFFFFFF) % (uint32_t)(n - 1), n);
+                    break;
+
+                default:  //CONTINUOUS, a single value
+                    break;
+            }
+
+            values[i] = OptBoundaries<T, N>::unit_of_level(next, n);
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///out = reference + change per dimension, consuming three words per dimension as calculate_random_change does
+    ///two for the factor and one for the sign, branch free so it vectorizes
+    static void add_random_changes(T const* reference, T* out, size_t d, T temperature, uint32_t const* words) {
+        const T maxChange = (T)0.5 * temperature;
+
+        for (size_t i = 0; i < d; ++i) {
+            const T change = OptRandom::to_uniform<T>(words[3 * i], words[3 * i + 1]) * maxChange;
+            out[i]         = reference[i] + ((words[3 * i + 2] >> 31) ? -change : change);
         }
-        return true;
+    }
+
+    //------------------------------------------------------------------------------
+
+    static void to_user(OptCalculation<T, N> const& unitCalculation, OptBoundaries<T, N> const& boundaries, OptCalculation<T, N>& out) {
+        if (out.get_schema() != unitCalculation.get_schema())
+            out = OptCalculation<T, N>(unitCalculation.get_schema());
+
+        boundaries.to_user(unitCalculation.data(), out.data());
+        out.result = unitCalculation.result;
+    }
+
+    //------------------------------------------------------------------------------
+
+    static OptCalculation<T, N> to_user(OptCalculation<T, N> const& unitCalculation, OptBoundaries<T, N> const& boundaries) {
+        OptCalculation<T, N> out;
+        to_user(unitCalculation, boundaries, out);
+        return out;
     }
 };
 
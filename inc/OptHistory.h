@@ -0,0 +1,213 @@
+/*
+    Copyright (c) 2017 Martin Buck
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation the rights to
+    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+    The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+    OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef OPTHISTORY_H
+#define OPTHISTORY_H
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "OptCalculation.h"
+#include "OptStorage.h"
+#include "OptTarget.h"
+
+namespace cppOpt {
+
+using namespace std;
+
+///columnar store of finished calculations
+///every parameter, the results, the ids of the children and the sequence numbers are kept in their own contiguous column
+template<typename T, size_t N = dynamicSize>
+class OptHistory {
+    schema_t
+        schema;
+
+    storage_t<vector<T>, N>
+        columns{};
+
+    vector<T>
+        results;
+
+    vector<size_t>
+        childIds,
+        sequenceNumbers;
+
+    //------------------------------------------------------------------------------
+
+   public:
+    void push_back(OptCalculation<T, N> const& optCalculation, size_t childId = 0, size_t sequenceNumber = 0) {
+        if (!schema) {
+            schema = optCalculation.get_schema();
+            if constexpr (N == dynamicSize)
+                columns.resize(optCalculation.size());
+        }
+
+        for (size_t i = 0; i < columns.size(); ++i)
+            columns[i].push_back(optCalculation.get_parameter(i));
+
+        results.push_back(optCalculation.result);
+        childIds.push_back(childId);
+        sequenceNumbers.push_back(sequenceNumber);
+    }
+
+    //------------------------------------------------------------------------------
+
+    void reserve(size_t n) {
+        for (auto& column : columns)
+            column.reserve(n);
+
+        results.reserve(n);
+        childIds.reserve(n);
+        sequenceNumbers.reserve(n);
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///keeps the schema and the capacity, so it can be refilled without allocating
+    void clear() {
+        for (auto& column : columns)
+            column.clear();
+
+        results.clear();
+        childIds.clear();
+        sequenceNumbers.clear();
+    }
+
+    //------------------------------------------------------------------------------
+
+    size_t size() const {
+        return results.size();
+    }
+
+    //------------------------------------------------------------------------------
+
+    bool empty() const {
+        return results.empty();
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///materializes the calculation at index
+    OptCalculation<T, N> operator[](size_t index) const {
+        OptCalculation<T, N> out(schema);
+
+        for (size_t i = 0; i < columns.size(); ++i)
+            out.set_parameter(i, columns[i][index]);
+
+        out.result = results[index];
+        return out;
+    }
+
+    //------------------------------------------------------------------------------
+
+    OptCalculation<T, N> back() const {
+        return (*this)[size() - 1];
+    }
+
+    //------------------------------------------------------------------------------
+
+    vector<T> const& column(size_t parameterIndex) const {
+        return columns[parameterIndex];
+    }
+
+    //------------------------------------------------------------------------------
+
+    vector<T> const& get_results() const {
+        return results;
+    }
+
+    //------------------------------------------------------------------------------
+
+    vector<size_t> const& get_child_ids() const {
+        return childIds;
+    }
+
+    //------------------------------------------------------------------------------
+
+    vector<size_t> const& get_sequence_numbers() const {
+        return sequenceNumbers;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///index of the best result, the first one in case of ties
+    ///must not be called on an empty history
+    size_t index_best(OptTarget optTarget, T targetValue) const {
+        vector<T> keys = sort_values(optTarget, targetValue);
+
+        return min_element(keys.begin(), keys.end()) - keys.begin();
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///indices of the n best results, best first, ties are ordered by insertion
+    vector<size_t> indices_best(size_t n, OptTarget optTarget, T targetValue) const {
+        vector<T>      keys = sort_values(optTarget, targetValue);
+        vector<size_t> indices(size());
+
+        iota(indices.begin(), indices.end(), 0);
+        n = std::min(n, indices.size());
+
+        partial_sort(indices.begin(), indices.begin() + n, indices.end(), [&keys](size_t a, size_t b) {
+            return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+        });
+
+        indices.resize(n);
+        return indices;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///per result value which is smaller the better the result is
+    vector<T> sort_values(OptTarget optTarget, T targetValue) const {
+        const size_t n = results.size();
+        const T*     r = results.data();
+        vector<T>    keys(n);
+        T*           k = keys.data();
+
+        switch (optTarget) {
+            case OptTarget::MINIMIZE:
+                for (size_t i = 0; i < n; ++i)
+                    k[i] = r[i];
+                break;
+
+            case OptTarget::MAXIMIZE:
+                for (size_t i = 0; i < n; ++i)
+                    k[i] = -r[i];
+                break;
+
+            case OptTarget::APPROACH:
+                for (size_t i = 0; i < n; ++i)
+                    k[i] = fabs(targetValue - r[i]);
+                break;
+
+            case OptTarget::DIVERGE:
+                for (size_t i = 0; i < n; ++i)
+                    k[i] = -fabs(targetValue - r[i]);
+                break;
+
+            default:  // MINIMIZE
+                for (size_t i = 0; i < n; ++i)
+                    k[i] = r[i];
+        }
+        return keys;
+    }
+
+    //------------------------------------------------------------------------------
+};
+
+}  // namespace cppOpt
+
+#endif  // OPTHISTORY_H
@@ -0,0 +1,88 @@
+/*
+    Copyright (c) 2017 Martin Buck
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation the rights to
+    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+    The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+    OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef OPTPARAMETERSCHEMA_H
+#define OPTPARAMETERSCHEMA_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cppOpt {
+
+using namespace std;
+
+///immutable mapping between parameter names and their index within an OptCalculation
+///built once per OptBoundaries and shared by all calculations created from them
+class OptParameterSchema final {
+    vector<string>
+        names;
+
+    map<string, size_t>
+        indices;
+
+    //------------------------------------------------------------------------------
+
+   public:
+    OptParameterSchema() = default;
+
+    explicit OptParameterSchema(vector<string> names) :
+        names(move(names)) {
+        for (size_t i = 0; i < this->names.size(); ++i)
+            indices.emplace(this->names[i], i);
+    }
+
+    //------------------------------------------------------------------------------
+
+    size_t size() const {
+        return names.size();
+    }
+
+    //------------------------------------------------------------------------------
+
+    string const& name(size_t index) const {
+        return names[index];
+    }
+
+    //------------------------------------------------------------------------------
+
+    vector<string> const& get_names() const {
+        return names;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///throws out_of_range if the name is unknown
+    size_t index_of(string const& name) const {
+        return indices.at(name);
+    }
+
+    //------------------------------------------------------------------------------
+
+    bool contains(string const& name) const {
+        return indices.find(name) != indices.end();
+    }
+
+    //------------------------------------------------------------------------------
+
+    bool same_as(OptParameterSchema const& other) const {
+        return this == &other || names == other.names;
+    }
+};
+
+using schema_t = shared_ptr<const OptParameterSchema>;
+
+}  // namespace cppOpt
+
+#endif  // OPTPARAMETERSCHEMA_H
@@ -0,0 +1,138 @@
+/*
+    Copyright (c) 2017 Martin Buck
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation the rights to
+    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+    The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+    OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef OPTQUEUE_H
+#define OPTQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace cppOpt {
+
+using namespace std;
+
+constexpr size_t cacheLineSize = 64;
+
+///bounded lock-free multi-producer / multi-consumer queue
+///every cell carries a sequence number telling producers and consumers whether it's their turn
+///see http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+template<typename T>
+class OptQueue final {
+    struct alignas(cacheLineSize) Cell {
+        atomic<size_t>
+            sequence;
+
+        T
+            value;
+    };
+
+    unique_ptr<Cell[]>
+        cells;
+
+    size_t
+        mask;
+
+    alignas(cacheLineSize) atomic<size_t>
+        enqueuePosition{0};
+
+    alignas(cacheLineSize) atomic<size_t>
+        dequeuePosition{0};
+
+    //------------------------------------------------------------------------------
+
+   public:
+    ///the capacity is rounded up to the next power of two
+    explicit OptQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+
+        cells = make_unique<Cell[]>(size);
+        mask  = size - 1;
+
+        for (size_t i = 0; i < size; ++i)
+            cells[i].sequence.store(i, memory_order_relaxed);
+    }
+
+    //------------------------------------------------------------------------------
+
+    OptQueue(OptQueue const&) = delete;
+    OptQueue& operator=(OptQueue const&) = delete;
+
+    //------------------------------------------------------------------------------
+
+    ///returns false if the queue is full
+    bool try_push(T&& value) {
+        Cell*  cell;
+        size_t position = enqueuePosition.load(memory_order_relaxed);
+
+        while (true) {
+            cell                = &cells[position & mask];
+            size_t   sequence   = cell->sequence.load(memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+                    break;
+            } else if (difference < 0)
+                return false;
+            else
+                position = enqueuePosition.load(memory_order_relaxed);
+        }
+
+        cell->value = move(value);
+        cell->sequence.store(position + 1, memory_order_release);
+        return true;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///returns nullopt if the queue is empty
+    optional<T> try_pop() {
+        Cell*  cell;
+        size_t position = dequeuePosition.load(memory_order_relaxed);
+
+        while (true) {
+            cell                = &cells[position & mask];
+            size_t   sequence   = cell->sequence.load(memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+
+            if (difference == 0) {
+                if (dequeuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+                    break;
+            } else if (difference < 0)
+                return nullopt;
+            else
+                position = dequeuePosition.load(memory_order_relaxed);
+        }
+
+        optional<T> out(move(cell->value));
+        cell->sequence.store(position + mask + 1, memory_order_release);
+        return out;
+    }
+
+    //------------------------------------------------------------------------------
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+    //------------------------------------------------------------------------------
+};
+
+}  // namespace cppOpt
+
+#endif  // OPTQUEUE_H
@@ -0,0 +1,330 @@
+/*
+    Copyright (c) 2017 Martin Buck
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation the rights to
+    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+    The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+    OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef OPTRANDOM_H
+#define OPTRANDOM_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include "IOptDesign.h"
+
+namespace cppOpt {
+
+using namespace std;
+
+///counter-based Philox4x32-10 random engine, keyed by the seed
+///the counter consists of the stream (the id of the child), the index of the evaluation and the position within it
+///so the random numbers of any evaluation can be regenerated without replaying the ones before
+///see Salmon et al. "Parallel random numbers: as easy as 1, 2, 3"
+///bulk draws generate whole blocks with AVX-512 or AVX2 if enabled at compile time, yielding the same numbers as drawing them one by one
+class OptRandom final {
+    array<uint32_t, 2>
+        key;
+
+    uint32_t
+        stream,
+        block{0};  //position within the evaluation, in blocks of four words
+
+    uint64_t
+        evaluation{0};
+
+    array<uint32_t, 4>
+        buffer{};
+
+    unsigned int
+        nBuffered{0};
+
+    vector<uint32_t>  //reused by the bulk draws
+        scratch;
+
+    IOptDesign const*  //start points are taken from it if set
+        design{nullptr};
+
+    uint64_t
+        designIndex{0},
+        designStride{1};
+
+    //------------------------------------------------------------------------------
+
+   public:
+    explicit OptRandom(uint64_t seed = 0, uint64_t stream = 0) :
+        key{{uint32_t(seed), uint32_t(seed >> 32)}},
+        stream(uint32_t(stream)) {}
+
+    //------------------------------------------------------------------------------
+
+    ///continues with the random numbers of the given evaluation, in constant time
+    void seek(uint64_t evaluation) {
+        this->evaluation = evaluation;
+        block            = 0;
+        nBuffered        = 0;
+    }
+
+    //------------------------------------------------------------------------------
+
+    void next_evaluation() {
+        seek(evaluation + 1);
+    }
+
+    //------------------------------------------------------------------------------
+
+    uint64_t get_evaluation() const {
+        return evaluation;
+    }
+
+    //------------------------------------------------------------------------------
+
+    uint32_t next32() {
+        if (nBuffered == 0) {
+            buffer    = philox({{block++, stream, uint32_t(evaluation), uint32_t(evaluation >> 32)}}, key);
+            nBuffered = 4;
+        }
+        return buffer[4 - nBuffered--];
+    }
+
+    //------------------------------------------------------------------------------
+
+    uint64_t next() {
+        const uint64_t low = next32();
+        return (uint64_t(next32()) << 32) | low;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///uniformly distributed within [0, 1)
+    template<typename T>
+    T uniform() {
+        const uint32_t low = next32();
+        return to_uniform<T>(low, next32());
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///the same as n calls of next32()
+    void fill(uint32_t* out, size_t n) {
+        size_t i = 0;
+        for (; i < n && nBuffered > 0; ++i)
+            out[i] = next32();
+
+        const size_t nBlocks = (n - i) / 4;
+        philox_blocks(nBlocks, out + i);
+        block += uint32_t(nBlocks);
+        i += 4 * nBlocks;
+
+        for (; i < n; ++i)
+            out[i] = next32();
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///the next n words, valid until the next bulk draw
+    uint32_t const* words(size_t n) {
+        if (scratch.size() < n)
+            scratch.resize(n);
+
+        fill(scratch.data(), n);
+        return scratch.data();
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///the same as n calls of uniform<T>()
+    template<typename T>
+    void fill_uniform(T* out, size_t n) {
+        uint32_t const* w = words(2 * n);
+        for (size_t i = 0; i < n; ++i)
+            out[i] = to_uniform<T>(w[2 * i], w[2 * i + 1]);
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///standard normal distributed, via Box-Muller on pairs of uniforms
+    template<typename T>
+    void fill_normal(T* out, size_t n) {
+        const size_t    nPairs = (n + 1) / 2;
+        uint32_t const* w      = words(4 * nPairs);
+
+        for (size_t i = 0; i < nPairs; ++i) {
+            const T
+                radius = sqrt(T(-2) * log(T(1) - to_uniform<T>(w[4 * i], w[4 * i + 1]))),
+                angle  = T(2 * M_PI) * to_uniform<T>(w[4 * i + 2], w[4 * i + 3]);
+
+            out[2 * i] = radius * cos(angle);
+            if (2 * i + 1 < n)
+                out[2 * i + 1] = radius * sin(angle);
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///start points are taken from the points first, first + stride, first + 2 * stride, ... of the design
+    ///so engines with the same stride and a different first never share a point
+    void use_design(IOptDesign const* design, uint64_t first, uint64_t stride) {
+        this->design = design;
+        designIndex  = first;
+        designStride = stride;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///the next start point of the design, returns false if no design is used
+    template<typename T>
+    bool next_design_point(T* out, size_t d) {
+        if (!design)
+            return false;
+
+        for (size_t i = 0; i < d; ++i)
+            out[i] = T(design->coordinate(designIndex, i));
+
+        designIndex += designStride;
+        return true;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///the uniform within [0, 1) made of two consecutive words
+    template<typename T>
+    static T to_uniform(uint32_t low, uint32_t high) {
+        return (((uint64_t(high) << 32) | low) >> 11) * (T(1) / T(uint64_t(1) << 53));
+    }
+
+    //------------------------------------------------------------------------------
+
+    bool coin() {
+        return next32() >> 31;
+    }
+
+    //------------------------------------------------------------------------------
+
+    static array<uint32_t, 4> philox(array<uint32_t, 4> counter, array<uint32_t, 2> key) {
+        for (int round = 0; round < 10; ++round) {
+            const uint64_t
+                p0 = uint64_t(0xD2511F53) * counter[0],
+                p1 = uint64_t(0xCD9E8D57) * counter[2];
+
+            counter = {{uint32_t(p1 >> 32) ^ counter[1] ^ key[0],
+                        uint32_t(p1),
+                        uint32_t(p0 >> 32) ^ counter[3] ^ key[1],
+                        uint32_t(p0)}};
+
+            key[0] += 0x9E3779B9;
+            key[1] += 0xBB67AE85;
+        }
+        return counter;
+    }
+
+    //------------------------------------------------------------------------------
+
+   private:
+    ///nBlocks whole blocks of the current evaluation, starting at the current block
+    ///the vectorized paths keep every word of a block in its own register, one block per 64 bit lane
+    void philox_blocks(size_t nBlocks, uint32_t* out) const {
+        size_t b = 0;
+
+#if defined(__AVX512F__)
+        {
+            const __m512i
+                mask = _mm512_set1_epi64(0xFFFFFFFF),
+                m0   = _mm512_set1_epi64(0xD2511F53),
+                m1   = _mm512_set1_epi64(0xCD9E8D57),
+                low  = _mm512_set_epi64(11, 3, 10, 2, 9, 1, 8, 0),
+                high = _mm512_set_epi64(15, 7, 14, 6, 13, 5, 12, 4);
+
+            for (; b + 8 <= nBlocks; b += 8) {
+                __m512i
+                    c0 = _mm512_and_si512(_mm512_add_epi64(_mm512_set1_epi64(uint64_t(block) + b), _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0)), mask),
+                    c1 = _mm512_set1_epi64(stream),
+                    c2 = _mm512_set1_epi64(uint32_t(evaluation)),
+                    c3 = _mm512_set1_epi64(uint32_t(evaluation >> 32));
+
+                for (uint32_t round = 0; round < 10; ++round) {
+                    const __m512i
+                        p0 = _mm512_mul_epu32(c0, m0),
+                        p1 = _mm512_mul_epu32(c2, m1);
+
+                    c0 = _mm512_xor_si512(_mm512_xor_si512(_mm512_srli_epi64(p1, 32), c1), _mm512_set1_epi64(uint32_t(key[0] + round * 0x9E3779B9)));
+                    c1 = _mm512_and_si512(p1, mask);
+                    c2 = _mm512_xor_si512(_mm512_xor_si512(_mm512_srli_epi64(p0, 32), c3), _mm512_set1_epi64(uint32_t(key[1] + round * 0xBB67AE85)));
+                    c3 = _mm512_and_si512(p0, mask);
+                }
+
+                //words 0 and 1 and words 2 and 3 of every block as 64 bit lanes, interleaved into the order of the blocks
+                const __m512i
+                    w01 = _mm512_or_si512(c0, _mm512_slli_epi64(c1, 32)),
+                    w23 = _mm512_or_si512(c2, _mm512_slli_epi64(c3, 32));
+
+                _mm512_storeu_si512(out + 4 * b, _mm512_permutex2var_epi64(w01, low, w23));
+                _mm512_storeu_si512(out + 4 * b + 16, _mm512_permutex2var_epi64(w01, high, w23));
+            }
+        }
+#endif
+
+#if defined(__AVX2__)
+        {
+            const __m256i
+                mask = _mm256_set1_epi64x(0xFFFFFFFF),
+                m0   = _mm256_set1_epi64x(0xD2511F53),
+                m1   = _mm256_set1_epi64x(0xCD9E8D57);
+
+            for (; b + 4 <= nBlocks; b += 4) {
+                __m256i
+                    c0 = _mm256_and_si256(_mm256_add_epi64(_mm256_set1_epi64x(uint64_t(block) + b), _mm256_set_epi64x(3, 2, 1, 0)), mask),
+                    c1 = _mm256_set1_epi64x(stream),
+                    c2 = _mm256_set1_epi64x(uint32_t(evaluation)),
+                    c3 = _mm256_set1_epi64x(uint32_t(evaluation >> 32));
+
+                for (uint32_t round = 0; round < 10; ++round) {
+                    const __m256i
+                        p0 = _mm256_mul_epu32(c0, m0),
+                        p1 = _mm256_mul_epu32(c2, m1);
+
+                    c0 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(p1, 32), c1), _mm256_set1_epi64x(uint32_t(key[0] + round * 0x9E3779B9)));
+                    c1 = _mm256_and_si256(p1, mask);
+                    c2 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(p0, 32), c3), _mm256_set1_epi64x(uint32_t(key[1] + round * 0xBB67AE85)));
+                    c3 = _mm256_and_si256(p0, mask);
+                }
+
+                //unpacking works within 128 bit halves, yielding the blocks 0 and 2 and the blocks 1 and 3
+                const __m256i
+                    w01  = _mm256_or_si256(c0, _mm256_slli_epi64(c1, 32)),
+                    w23  = _mm256_or_si256(c2, _mm256_slli_epi64(c3, 32)),
+                    even = _mm256_unpacklo_epi64(w01, w23),
+                    odd  = _mm256_unpackhi_epi64(w01, w23);
+
+                _mm256_storeu_si256((__m256i*)(out + 4 * b), _mm256_permute2x128_si256(even, odd, 0x20));
+                _mm256_storeu_si256((__m256i*)(out + 4 * b + 8), _mm256_permute2x128_si256(even, odd, 0x31));
+            }
+        }
+#endif
+
+        for (; b < nBlocks; ++b) {
+            const auto words = philox({{uint32_t(block + b), stream, uint32_t(evaluation), uint32_t(evaluation >> 32)}}, key);
+            for (size_t i = 0; i < 4; ++i)
+                out[4 * b + i] = words[i];
+        }
+    }
+
+    //------------------------------------------------------------------------------
+};
+
+}  // namespace cppOpt
+
+#endif  // OPTRANDOM_H
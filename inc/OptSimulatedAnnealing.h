@@ -18,11 +18,17 @@
 
 namespace cppOpt {
 
-template<typename T>
-class OptSimulatedAnnealing final : public IOptAlgorithm<T> {
-    OptBoundaries<T>
+template<typename T, size_t N = dynamicSize>
+class OptSimulatedAnnealing final : public IOptAlgorithm<T, N> {
+    OptBoundaries<T, N>
         boundaries;
 
+    optional<OptCalculation<T, N>>
+        last;  //the most recent result
+
+    OptRetryCounter
+        retries;
+
     const T
         coolingFactor;
 
@@ -34,9 +40,9 @@ class OptSimulatedAnnealing final : public IOptAlgorithm<T> {
 
    public:
     OptSimulatedAnnealing(
-        OptBoundaries<T> boundaries,
-        T                coolingFactor,
-        T                startChance) :
+        OptBoundaries<T, N> boundaries,
+        T                   coolingFactor,
+        T                   startChance) :
 
                          boundaries(move(boundaries)),
                          coolingFactor(move(coolingFactor)),
@@ -44,29 +50,18 @@ class OptSimulatedAnnealing final : public IOptAlgorithm<T> {
 
     //------------------------------------------------------------------------------
 
-    OptCalculation<T> get_next_calculation(
-        vector<OptCalculation<T>> const& previous,
-        OptCalculation<T> const*         best) final {
-        if (previous.empty() || !best)
-            return OptHelper<T>::random_calculation(boundaries);
+    OptCalculation<T, N> get_next_calculation(OptCalculation<T, N> const* best, OptRandom& random) final {
+        if (!last || !best)
+            return OptHelper<T, N>::random_calculation(boundaries, random);
 
-        OptCalculation<T> referenceValue, newValue;
+        OptCalculation<T, N> referenceValue, newValue;
 
-        if (OptHelper<T>::random_factor() < chance)
-            referenceValue = previous.back();
+        if (OptHelper<T, N>::random_factor(random) < chance)
+            referenceValue = *last;
         else
             referenceValue = *best;
 
-        while (true) {
-            newValue = OptCalculation<T>();
-            for (auto const& boundary : boundaries) {
-                T change = OptHelper<T>::calculate_random_change(boundary.second, temperature);
-
-                newValue.add_parameter(boundary.first, referenceValue.get_parameter(boundary.first) + change);
-            }
-            if (OptHelper<T>::valid(newValue, boundaries))
-                break;
-        }
+        newValue = OptHelper<T, N>::valid_neighbour(referenceValue, boundaries, temperature, random, retries);
 
         update_temperature();
         update_chance();
@@ -76,8 +71,38 @@ class OptSimulatedAnnealing final : public IOptAlgorithm<T> {
 
     //------------------------------------------------------------------------------
 
+    ///speculative proposals, all of them based on the calculations known so far
+    ///every proposal uses the random numbers of its own evaluation
+    void ask(
+        size_t                        n,
+        OptCalculation<T, N> const*   best,
+        OptRandom&                    random,
+        vector<OptCalculation<T, N>>& candidates) final {
+        for (size_t i = 0; i < n; ++i) {
+            if (i > 0)
+                random.next_evaluation();
+
+            candidates.push_back(get_next_calculation(best, random));
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    void on_result(OptCalculation<T, N> const& result) final {
+        last = result;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///how often proposals were drawn again, since they left boundaries with OptBoundaryPolicy::REJECT
+    OptRetryCounter const& get_retries() const {
+        return retries;
+    }
+
+    //------------------------------------------------------------------------------
+
    private:
-    OptBoundaries<T> const& get_boundaries() final {
+    OptBoundaries<T, N> const& get_boundaries() final {
         return boundaries;
     }
 
@@ -0,0 +1,168 @@
+/*
+    Copyright (c) 2017 Martin Buck
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation the rights to
+    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+    The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+    OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef OPTSOBOL_H
+#define OPTSOBOL_H
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+#include "IOptDesign.h"
+
+namespace cppOpt {
+
+using namespace std;
+
+///Sobol sequence with the direction numbers of Joe and Kuo, Owen-scrambled per dimension
+///the scrambling follows Burley "Practical Hash-based Owen Scrambling", the seed selects the scrambling
+///points are computed directly from their index, for up to 2^32 points
+class OptSobol final : public IOptDesign {
+    static constexpr size_t
+        nDimensions = 21,
+        nBits       = 32;
+
+    using directions_t = array<array<uint32_t, nBits>, nDimensions>;
+
+    uint64_t
+        seed;
+
+    //------------------------------------------------------------------------------
+
+   public:
+    explicit OptSobol(uint64_t seed = 0) :
+        seed(seed) {}
+
+    //------------------------------------------------------------------------------
+
+    double coordinate(uint64_t index, size_t dimension) const final {
+        if (dimension >= nDimensions)
+            throw out_of_range("Sobol designs only support up to 21 dimensions");
+
+        auto const& v = directions()[dimension];
+        uint32_t    x = 0;
+
+        for (size_t bit = 0; bit < nBits && (index >> bit) != 0; ++bit)
+            if ((index >> bit) & 1)
+                x ^= v[bit];
+
+        return owen_scramble(x, scramble_seed(dimension)) * (1.0 / 4294967296.0);
+    }
+
+    //------------------------------------------------------------------------------
+
+    size_t max_dimensions() const final {
+        return nDimensions;
+    }
+
+    //------------------------------------------------------------------------------
+
+   private:
+    static directions_t const& directions() {
+        //degree, coefficients and initial numbers m of the primitive polynomial per dimension, the first one is van der Corput
+        struct Polynomial {
+            unsigned int
+                degree,
+                coefficients;
+
+            array<uint32_t, 7>
+                m;
+        };
+
+        static const array<Polynomial, nDimensions - 1> polynomials{{
+            {1, 0, {1}},
+            {2, 1, {1, 3}},
+            {3, 1, {1, 3, 1}},
+            {3, 2, {1, 1, 1}},
+            {4, 1, {1, 1, 3, 3}},
+            {4, 4, {1, 3, 5, 13}},
+            {5, 2, {1, 1, 5, 5, 17}},
+            {5, 4, {1, 1, 5, 5, 5}},
+            {5, 7, {1, 1, 7, 11, 19}},
+            {5, 11, {1, 1, 5, 1, 1}},
+            {5, 13, {1, 1, 1, 3, 11}},
+            {5, 14, {1, 3, 5, 5, 31}},
+            {6, 1, {1, 3, 3, 9, 7, 49}},
+            {6, 13, {1, 1, 1, 15, 21, 21}},
+            {6, 16, {1, 3, 1, 13, 27, 49}},
+            {6, 19, {1, 1, 1, 15, 7, 5}},
+            {6, 22, {1, 3, 1, 15, 13, 25}},
+            {6, 25, {1, 1, 5, 5, 19, 61}},
+            {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+            {7, 4, {1, 3, 7, 13, 13, 15, 69}},
+        }};
+
+        static const directions_t out = []() {
+            directions_t v{};
+
+            for (size_t bit = 0; bit < nBits; ++bit)
+                v[0][bit] = uint32_t(1) << (nBits - 1 - bit);
+
+            for (size_t d = 1; d < nDimensions; ++d) {
+                auto const& p = polynomials[d - 1];
+
+                for (size_t bit = 0; bit < p.degree; ++bit)
+                    v[d][bit] = p.m[bit] << (nBits - 1 - bit);
+
+                for (size_t bit = p.degree; bit < nBits; ++bit) {
+                    v[d][bit] = v[d][bit - p.degree] ^ (v[d][bit - p.degree] >> p.degree);
+                    for (size_t k = 1; k < p.degree; ++k)
+                        if ((p.coefficients >> (p.degree - 1 - k)) & 1)
+                            v[d][bit] ^= v[d][bit - k];
+                }
+            }
+            return v;
+        }();
+
+        return out;
+    }
+
+    //------------------------------------------------------------------------------
+
+    uint32_t scramble_seed(size_t dimension) const {
+        //splitmix64 finalizer
+        uint64_t z = seed + (dimension + 1) * 0x9E3779B97F4A7C15;
+        z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z          = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+        return uint32_t(z ^ (z >> 31));
+    }
+
+    //------------------------------------------------------------------------------
+
+    static uint32_t reverse_bits(uint32_t x) {
+        x = ((x >> 1) & 0x55555555) | ((x & 0x55555555) << 1);
+        x = ((x >> 2) & 0x33333333) | ((x & 0x33333333) << 2);
+        x = ((x >> 4) & 0x0F0F0F0F) | ((x & 0x0F0F0F0F) << 4);
+        x = ((x >> 8) & 0x00FF00FF) | ((x & 0x00FF00FF) << 8);
+        return (x >> 16) | (x << 16);
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///every bit is flipped depending on the bits above it only, so the scrambled points stay a (t, s)-sequence
+    static uint32_t owen_scramble(uint32_t x, uint32_t seed) {
+        x = reverse_bits(x);
+        x += seed;
+        x ^= x * 0x6C50B47C;
+        x ^= x * 0xB82F1E52;
+        x ^= x * 0xC7AFE638;
+        x ^= x * 0x8D22F6E6;
+        return reverse_bits(x);
+    }
+
+    //------------------------------------------------------------------------------
+};
+
+}  // namespace cppOpt
+
+#endif  // OPTSOBOL_H
@@ -0,0 +1,42 @@
+/*
+    Copyright (c) 2017 Martin Buck
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation the rights to
+    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+    The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+    OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef OPTSTORAGE_H
+#define OPTSTORAGE_H
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace cppOpt {
+
+using namespace std;
+
+///number of parameters only known at runtime
+constexpr size_t dynamicSize = 0;
+
+///per parameter storage, fixed sized if the number of parameters is known at compile time
+template<typename T, size_t N>
+using storage_t = conditional_t<N == dynamicSize, vector<T>, array<T, N>>;
+
+///tag to refer to a parameter by a compile time index
+///e.g. using X = OptIndex<0>; optCalculation.get<X>()
+template<size_t I>
+struct OptIndex {
+    static constexpr size_t index = I;
+};
+
+}  // namespace cppOpt
+
+#endif  // OPTSTORAGE_H
@@ -0,0 +1,294 @@
+/*
+    Copyright (c) 2015 Martin Buck
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation the rights to
+    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+    The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+    OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef OPTTABOO_H
+#define OPTTABOO_H
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "OptBoundaries.h"
+#include "OptCalculation.h"
+#include "OptStorage.h"
+
+namespace cppOpt {
+
+using namespace std;
+
+///balls which candidates must not be placed in, within the unit cube of the boundaries they were declared for
+///their centers are indexed by a kd-tree, every node knowing the largest radius below it
+///so a lookup only descends into halves a ball could still reach from
+///all a lookup needs of a node is stored in a single record, so it touches a single cache line per node
+///recent regions are kept in a second, smaller tree, so adding many regions doesn't rebuild the large one every time
+///regions added since the last build are checked one by one, until enough of them pile up to rebuild the small tree
+template<typename T, size_t N = dynamicSize>
+class OptTaboo final {
+    static constexpr size_t
+        maxPending = 32;
+
+    OptBoundaries<T, N>
+        boundaries;
+
+    size_t
+        d;
+
+    vector<T>  //d values per region
+        centers,
+        radii;
+
+    size_t  //the center, the radius, the largest radius within the subtree and the splitting axis
+        stride;
+
+    size_t
+        nLarge{0},  //regions [0, nLarge) are within the large tree, [nLarge, nIndexed) within the small one
+        nIndexed{0};
+
+    vector<size_t>  //the region at every node, the node of the range [lo, hi) is at (lo + hi) / 2
+        nodes;
+
+    vector<T>  //a record of stride values per node
+        records;
+
+    //------------------------------------------------------------------------------
+
+   public:
+    explicit OptTaboo(OptBoundaries<T, N> boundaries) :
+        boundaries(move(boundaries)),
+        d(this->boundaries.dimensions()),
+        stride(d + 3) {}
+
+    //------------------------------------------------------------------------------
+
+    ///values within the boundaries, the radius is relative to the unit cube
+    void add(T const* values, T radius) {
+        T* unit = buffer();
+        boundaries.to_unit(values, unit);
+        add_unit(unit, radius);
+    }
+
+    //------------------------------------------------------------------------------
+
+    void add(OptCalculation<T, N> const& center, T radius) {
+        if (center.size() != d)
+            throw runtime_error("Taboo region has a different number of parameters than its boundaries");
+
+        add(center.data(), radius);
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///values within the unit cube of other boundaries over the same parameters, as handed out by algorithms searching them
+    void add(T const* unitValues, OptBoundaries<T, N> const& of, T radius) {
+        T* unit = buffer();
+        of.to_user(unitValues, unit);
+        boundaries.to_unit(unit, unit);
+        add_unit(unit, radius);
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///whether the values within the boundaries lie inside any of the regions
+    bool contains(T const* values) const {
+        T* unit = buffer();
+        boundaries.to_unit(values, unit);
+        return contains_unit(unit);
+    }
+
+    //------------------------------------------------------------------------------
+
+    bool contains(OptCalculation<T, N> const& optCalculation) const {
+        return contains(optCalculation.data());
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///as contains(values), for values within the unit cube of other boundaries over the same parameters
+    bool contains(T const* unitValues, OptBoundaries<T, N> const& of) const {
+        T* unit = buffer();
+        of.to_user(unitValues, unit);
+        boundaries.to_unit(unit, unit);
+        return contains_unit(unit);
+    }
+
+    //------------------------------------------------------------------------------
+
+    size_t size() const {
+        return radii.size();
+    }
+
+    //------------------------------------------------------------------------------
+
+    bool empty() const {
+        return radii.empty();
+    }
+
+    //------------------------------------------------------------------------------
+
+    OptBoundaries<T, N> const& get_boundaries() const {
+        return boundaries;
+    }
+
+    //------------------------------------------------------------------------------
+
+   private:
+    ///scratch for the conversion into the unit cube followed by the offsets of a lookup, per thread since lookups run concurrently
+    T* buffer() const {
+        thread_local vector<T> out;
+        out.resize(2 * d);
+        return out.data();
+    }
+
+    //------------------------------------------------------------------------------
+
+    void add_unit(T const* unit, T radius) {
+        centers.insert(centers.end(), unit, unit + d);
+        radii.push_back(radius);
+
+        if (radii.size() - nIndexed < maxPending)
+            return;
+
+        //the large tree is rebuilt once the small one grew to a 32nd of it, so every region is built into it O(log n) times
+        if (radii.size() - nLarge > std::max(maxPending, nLarge / 32)) {
+            build_range(0);
+            nLarge = radii.size();
+        } else
+            build_range(nLarge);
+
+        nIndexed = radii.size();
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///unit has to be the start of buffer(), its second half is used for the offsets
+    bool contains_unit(T* unit) const {
+        T* offsets = unit + d;
+        fill_n(offsets, d, (T)0);
+
+        if (contains_indexed(unit, offsets, 0, 0, nLarge) || contains_indexed(unit, offsets, 0, nLarge, nIndexed))
+            return true;
+
+        for (size_t region = nIndexed; region < radii.size(); ++region)
+            if (inside(unit, centers.data() + region * d, radii[region]))
+                return true;
+
+        return false;
+    }
+
+    //------------------------------------------------------------------------------
+
+    bool inside(T const* unit, T const* center, T radius) const {
+        T distance{0};
+
+        for (size_t i = 0; i < d; ++i)
+            distance += (unit[i] - center[i]) * (unit[i] - center[i]);
+
+        return distance < radius * radius;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///distance is the squared distance of unit to the cell of the range, the sum of the squared offsets per axis
+    ///all centers of the range are within the cell, so it's skipped once that is further away than any of their radii
+    bool contains_indexed(T const* unit, T* offsets, T distance, size_t lo, size_t hi) const {
+        if (lo >= hi)
+            return false;
+
+        const size_t mid    = (lo + hi) / 2;
+        T const*     record = records.data() + mid * stride;
+        const size_t axis   = (size_t)record[d + 2];
+
+        if (distance >= record[d + 1] * record[d + 1])
+            return false;
+
+        if (inside(unit, record, record[d]))
+            return true;
+
+        const T    difference = unit[axis] - record[axis];
+        const bool below      = difference < 0;
+
+        if (below ? contains_indexed(unit, offsets, distance, lo, mid) : contains_indexed(unit, offsets, distance, mid + 1, hi))
+            return true;
+
+        //the far cell starts at the splitting plane
+        const T farDistance = distance - offsets[axis] * offsets[axis] + difference * difference;
+        const T oldOffset   = offsets[axis];
+        offsets[axis]     = difference;
+
+        const bool out = below ? contains_indexed(unit, offsets, farDistance, mid + 1, hi) : contains_indexed(unit, offsets, farDistance, lo, mid);
+
+        offsets[axis] = oldOffset;
+        return out;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///a tree over the regions [lo, size())
+    void build_range(size_t lo) {
+        nodes.resize(radii.size());
+        iota(nodes.begin() + lo, nodes.end(), lo);
+        records.resize(nodes.size() * stride);
+
+        //centers added by values outside of the boundaries lie outside of the unit cube, which only makes the cells less even
+        vector<T>
+            cellLo(d, (T)0),
+            cellHi(d, (T)1);
+
+        build(lo, nodes.size(), cellLo, cellHi);
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///splits the longest side of the cell at the median of the centers, returns the reach of the range
+    T build(size_t lo, size_t hi, vector<T>& cellLo, vector<T>& cellHi) {
+        if (lo >= hi)
+            return (T)0;
+
+        size_t axis{0};
+        for (size_t i = 1; i < d; ++i)
+            if (cellHi[i] - cellLo[i] > cellHi[axis] - cellLo[axis])
+                axis = i;
+
+        const size_t mid = (lo + hi) / 2;
+        nth_element(nodes.begin() + lo, nodes.begin() + mid, nodes.begin() + hi, [this, axis](size_t a, size_t b) {
+            return centers[a * d + axis] < centers[b * d + axis];
+        });
+
+        const T
+            oldLo  = cellLo[axis],
+            oldHi  = cellHi[axis],
+            median = centers[nodes[mid] * d + axis];
+
+        cellHi[axis]  = median;
+        const T below = build(lo, mid, cellLo, cellHi);
+        cellHi[axis]  = oldHi;
+
+        cellLo[axis]  = median;
+        const T above = build(mid + 1, hi, cellLo, cellHi);
+        cellLo[axis]  = oldLo;
+
+        T* record = records.data() + mid * stride;
+        copy_n(centers.begin() + nodes[mid] * d, d, record);
+        record[d]     = radii[nodes[mid]];
+        record[d + 1] = std::max({record[d], below, above});
+        record[d + 2] = (T)axis;
+        return record[d + 1];
+    }
+
+    //------------------------------------------------------------------------------
+};
+
+}  // namespace cppOpt
+
+#endif  // OPTTABOO_H
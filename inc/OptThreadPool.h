@@ -0,0 +1,173 @@
+/*
+    Copyright (c) 2017 Martin Buck
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation the rights to
+    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+    The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+    OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef OPTTHREADPOOL_H
+#define OPTTHREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "OptQueue.h"
+
+namespace cppOpt {
+
+using namespace std;
+
+///work-stealing pool, every worker has its own queue and steals from the others once it runs dry
+///idle workers park until new tasks are pushed and only exit once no task is pending anymore
+template<typename Task>
+class OptThreadPool final {
+    vector<unique_ptr<OptQueue<Task>>>
+        queues;
+
+    alignas(cacheLineSize) atomic<size_t>
+        nPending{0};  //queued or being worked on
+
+    alignas(cacheLineSize) atomic<size_t>
+        nQueued{0};
+
+    atomic<size_t>
+        nParked{0};
+
+    atomic<bool>
+        stopped{false};
+
+    mutex
+        mParked;
+
+    condition_variable
+        cvParked;
+
+    //------------------------------------------------------------------------------
+
+   public:
+    ///capacity is the maximum number of tasks a single worker might have queued
+    OptThreadPool(size_t nWorkers, size_t capacity) {
+        nWorkers = std::max(nWorkers, size_t(1));
+        queues.reserve(nWorkers);
+        for (size_t i = 0; i < nWorkers; ++i)
+            queues.push_back(make_unique<OptQueue<Task>>(capacity));
+    }
+
+    //------------------------------------------------------------------------------
+
+    size_t size() const {
+        return queues.size();
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///queues the task at the given worker, where it might get stolen by the others
+    void push(size_t worker, Task&& task) {
+        ++nPending;
+        if (!queues[worker % queues.size()]->try_push(move(task))) {
+            --nPending;
+            throw runtime_error("Capacity of the worker queue exceeded");
+        }
+        ++nQueued;
+
+        if (nParked > 0) {
+            lock_guard<mutex> lck(mParked);
+            cvParked.notify_one();
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///lets all workers exit as soon as possible, discarding the tasks which are still queued
+    void stop() {
+        stopped = true;
+        lock_guard<mutex> lck(mParked);
+        cvParked.notify_all();
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///runs one thread per worker until all tasks are done
+    ///f(worker, task) may push further tasks and returns an optional continuation which the same worker executes next
+    template<typename F>
+    void run(F&& f) {
+        vector<thread> threads;
+        threads.reserve(queues.size());
+
+        for (size_t i = 0; i < queues.size(); ++i)
+            threads.emplace_back([this, i, &f]() { work(i, f); });
+
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///the loop of a single worker, can be called directly to work on the calling thread
+    template<typename F>
+    void work(size_t worker, F&& f) {
+        optional<Task> task{nullopt};
+
+        while (!stopped) {
+            if (!task)
+                task = pop(worker);
+
+            if (!task) {
+                if (!park())
+                    break;
+                continue;
+            }
+
+            task = f(worker, move(*task));
+
+            if (!task && --nPending == 0) {
+                lock_guard<mutex> lck(mParked);
+                cvParked.notify_all();
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+   private:
+    ///the own queue first, afterwards trying to steal from the others
+    optional<Task> pop(size_t worker) {
+        for (size_t i = 0; i < queues.size(); ++i) {
+            if (auto task = queues[(worker + i) % queues.size()]->try_pop()) {
+                --nQueued;
+                return task;
+            }
+        }
+        return nullopt;
+    }
+
+    //------------------------------------------------------------------------------
+
+    ///waits for new tasks, returns false if the worker should exit
+    bool park() {
+        unique_lock<mutex> lck(mParked);
+        ++nParked;
+        cvParked.wait(lck, [this]() { return stopped || nQueued > 0 || nPending == 0; });
+        --nParked;
+        return !stopped && nPending > 0;
+    }
+
+    //------------------------------------------------------------------------------
+};
+
+}  // namespace cppOpt
+
+#endif  // OPTTHREADPOOL_H
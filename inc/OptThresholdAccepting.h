@@ -18,9 +18,9 @@
 
 namespace cppOpt {
 
-template<typename T>
-class OptThresholdAccepting final : public IOptAlgorithm<T> {
-    OptBoundaries<T>
+template<typename T, size_t N = dynamicSize>
+class OptThresholdAccepting final : public IOptAlgorithm<T, N> {
+    OptBoundaries<T, N>
         boundaries;
 
     const OptTarget
@@ -29,10 +29,19 @@ class OptThresholdAccepting final : public IOptAlgorithm<T> {
     const T
         targetValue;
 
-    OptCalculation<T>
+    OptCalculation<T, N>
         optCalculationReference,
         optCalculationConfigurationC;
 
+    optional<OptCalculation<T, N>>
+        last;  //the most recent result
+
+    OptRetryCounter
+        retries;
+
+    size_t
+        nResults{0};
+
     const T
         coolingFactor,
         thresholdFactor;
@@ -43,12 +52,12 @@ class OptThresholdAccepting final : public IOptAlgorithm<T> {
 
    public:
     OptThresholdAccepting(
-        OptBoundaries<T> boundaries,
-        OptTarget        optTarget,
-        T                targetValue,
-        T                coolingFactor,
-        T                threshold,
-        T                thresholdFactor) :
+        OptBoundaries<T, N> boundaries,
+        OptTarget           optTarget,
+        T                   targetValue,
+        T                   coolingFactor,
+        T                   threshold,
+        T                   thresholdFactor) :
 
                              boundaries(move(boundaries)),
                              optTarget(move(optTarget)),
@@ -59,28 +68,17 @@ class OptThresholdAccepting final : public IOptAlgorithm<T> {
 
     //------------------------------------------------------------------------------
 
-    OptCalculation<T> get_next_calculation(
-        vector<OptCalculation<T>> const& previous,
-        OptCalculation<T> const*         best) final {
-        if (previous.empty() || !best)
-            return OptHelper<T>::random_calculation(boundaries);
+    OptCalculation<T, N> get_next_calculation(OptCalculation<T, N> const* best, OptRandom& random) final {
+        if (!last || !best)
+            return OptHelper<T, N>::random_calculation(boundaries, random);
 
-        OptCalculation<T> newValue;
+        OptCalculation<T, N> newValue;
 
-        if (previous.size() == 1) {
-            optCalculationReference      = previous[0];
-            optCalculationConfigurationC = previous[0];
+        if (nResults == 1) {
+            optCalculationReference      = *last;
+            optCalculationConfigurationC = *last;
 
-            while (true) {
-                newValue = OptCalculation<T>();
-                for (auto const& boundary : boundaries) {
-                    T change = OptHelper<T>::calculate_random_change(boundary.second, temperature);
-
-                    newValue.add_parameter(boundary.first, previous[0].get_parameter(boundary.first) + change);
-                }
-                if (OptHelper<T>::valid(newValue, boundaries))
-                    break;
-            }
+            newValue = OptHelper<T, N>::valid_neighbour(*last, boundaries, temperature, random, retries);
 
             update_temperature();
             update_threshold();
@@ -88,28 +86,19 @@ class OptThresholdAccepting final : public IOptAlgorithm<T> {
             return newValue;
         }
 
-        OptCalculation<T> referenceValue;
+        OptCalculation<T, N> referenceValue;
 
-        if (OptHelper<T>::result_better(previous.back(), optCalculationReference, optTarget, targetValue))
-            optCalculationReference = previous.back();
+        if (OptHelper<T, N>::result_better(*last, optCalculationReference, optTarget, targetValue))
+            optCalculationReference = *last;
 
-        OptCalculation<T> compareValue = compare_value();
+        OptCalculation<T, N> compareValue = compare_value();
 
-        if (OptHelper<T>::result_better(previous.back(), compareValue, optTarget, targetValue))
-            optCalculationConfigurationC = previous.back();
+        if (OptHelper<T, N>::result_better(*last, compareValue, optTarget, targetValue))
+            optCalculationConfigurationC = *last;
 
         referenceValue = optCalculationConfigurationC;
 
-        while (true) {
-            newValue = OptCalculation<T>();
-            for (auto const& boundary : boundaries) {
-                T change = OptHelper<T>::calculate_random_change(boundary.second, temperature);
-
-                newValue.add_parameter(boundary.first, referenceValue.get_parameter(boundary.first) + change);
-            }
-            if (OptHelper<T>::valid(newValue, boundaries))
-                break;
-        }
+        newValue = OptHelper<T, N>::valid_neighbour(referenceValue, boundaries, temperature, random, retries);
 
         update_temperature();
         update_threshold();
@@ -118,12 +107,48 @@ class OptThresholdAccepting final : public IOptAlgorithm<T> {
 
     //------------------------------------------------------------------------------
 
-    OptBoundaries<T> const& get_boundaries() final {
+    ///speculative proposals, all of them based on the calculations known so far
+    ///every proposal uses the random numbers of its own evaluation
+    void ask(
+        size_t                        n,
+        OptCalculation<T, N> const*   best,
+        OptRandom&                    random,
+        vector<OptCalculation<T, N>>& candidates) final {
+        for (size_t i = 0; i < n; ++i) {
+            if (i > 0)
+                random.next_evaluation();
+
+            candidates.push_back(get_next_calculation(best, random));
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    void on_result(OptCalculation<T, N> const& result) final {
+        last = result;
+
+        //a whole batch might be told before the next proposal, so the references can't wait for it
+        if (++nResults == 1) {
+            optCalculationReference      = result;
+            optCalculationConfigurationC = result;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+
+    OptBoundaries<T, N> const& get_boundaries() final {
         return boundaries;
     }
 
     //------------------------------------------------------------------------------
 
+    ///how often proposals were drawn again, since they left boundaries with OptBoundaryPolicy::REJECT
+    OptRetryCounter const& get_retries() const {
+        return retries;
+    }
+
+    //------------------------------------------------------------------------------
+
    private:
     void update_temperature() {
         temperature *= coolingFactor;
@@ -137,8 +162,8 @@ class OptThresholdAccepting final : public IOptAlgorithm<T> {
 
     //------------------------------------------------------------------------------
 
-    OptCalculation<T> compare_value() const {
-        OptCalculation<T> out;
+    OptCalculation<T, N> compare_value() const {
+        OptCalculation<T, N> out;
         switch (optTarget) {
             case OptTarget::MINIMIZE:
                 out.result = optCalculationConfigurationC.result + threshold;
@@ -21,8 +21,8 @@
 namespace cppOpt {
 using namespace std;
 
-template<typename T>
-using calc_t = function<void(OptCalculation<T>&)>;
+template<typename T, size_t N = dynamicSize>
+using calc_t = function<void(OptCalculation<T, N>&)>;
 }
 
 #endif  // OPTTYPES_H
@@ -15,15 +15,25 @@
 #define CPPOPT_H
 
 #include "config.h"
+#include "OptArchive.h"
 #include "OptBoundaries.h"
 #include "OptBoundary.h"
 #include "OptCalculation.h"
 #include "OptCoordinator.h"
 #include "OptEvolutionary.h"
 #include "OptGreatDeluge.h"
+#include "OptHalton.h"
 #include "OptHelper.h"
+#include "OptHistory.h"
+#include "OptParameterSchema.h"
+#include "OptQueue.h"
+#include "OptRandom.h"
 #include "OptSimulatedAnnealing.h"
+#include "OptSobol.h"
+#include "OptStorage.h"
+#include "OptTaboo.h"
 #include "OptTarget.h"
+#include "OptThreadPool.h"
 #include "OptThresholdAccepting.h"
 #include "OptTypes.h"
 
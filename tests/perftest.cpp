@@ -11,10 +11,15 @@
     OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <ctime>
 #include <iostream>
 #include <memory>
+#include <new>
+#include <thread>
 #include <vector>
 
 #include "cppOpt.h"
@@ -24,10 +29,32 @@ using namespace cppOpt;
 
 #define DELTA 0.01
 
+atomic<size_t> nAllocations{0};
+
+//not inlined, since compilers would otherwise complain about malloc() and free() being paired with new and delete
+[[gnu::noinline]] void* operator new(size_t size) {
+    ++nAllocations;
+    if (void* p = malloc(size))
+        return p;
+    throw bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
 auto toOptimize = [](OptCalculation<double>& optCalculation) {
     optCalculation.result = pow(optCalculation.get_parameter("X"), 2) + pow(optCalculation.get_parameter("Y"), 2) + 14.876;
 };
 
+auto toOptimizeFixed = [](OptCalculation<double, 2>& optCalculation) {
+    optCalculation.result = pow(optCalculation.get<0>(), 2) + pow(optCalculation.get<1>(), 2) + 14.876;
+};
+
 double time_sa_1() {
     auto start = clock();
 
@@ -170,6 +197,145 @@ double time_sa_4() {
     return (clock() - start) / (double)CLOCKS_PER_SEC;
 }
 
+double time_sa_5() {
+    auto start = clock();
+
+    OptBoundaries<double, 2> optBoundaries;
+    optBoundaries.add_boundary({-5.0, 5.0, "X"});
+    optBoundaries.add_boundary({-14.0, 23.0, "Y"});
+
+    unsigned int maxCalculations = 30000;
+    double       coolingFactor   = 0.95;
+    double       startChance     = 0.25;
+    OptTarget    optTarget       = OptTarget::MINIMIZE;
+
+    OptCoordinator<double, false, 2> coordinator(
+        maxCalculations,
+        toOptimizeFixed,
+        optTarget,
+        0);
+
+    coordinator.add_child(make_unique<OptSimulatedAnnealing<double, 2>>(
+        optBoundaries,
+        coolingFactor,
+        startChance));
+
+    coordinator.run_optimisation();
+
+    return (clock() - start) / (double)CLOCKS_PER_SEC;
+}
+
+//many children and threads with a cheap objective, so the time is dominated by the hand-off between the threads
+//measured in wall time, since clock() sums up the time of all threads
+double time_sa_contention() {
+    auto start = chrono::steady_clock::now();
+
+    OptBoundaries<double, 2> optBoundaries;
+    optBoundaries.add_boundary({-5.0, 5.0, "X"});
+    optBoundaries.add_boundary({-14.0, 23.0, "Y"});
+
+    unsigned int maxCalculations = 30000;
+    double       coolingFactor   = 0.95;
+    double       startChance     = 0.25;
+    OptTarget    optTarget       = OptTarget::MINIMIZE;
+
+    OptCoordinator<double, true, 2> coordinator(
+        maxCalculations,
+        toOptimizeFixed,
+        optTarget,
+        0);
+
+    for (int i = 0; i < 64; ++i)
+        coordinator.add_child(make_unique<OptSimulatedAnnealing<double, 2>>(
+            optBoundaries,
+            coolingFactor,
+            startChance));
+
+    coordinator.run_optimisation(32);
+
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+//random numbers drawn per second by all threads together, either from the global rand() or an OptRandom per thread
+double randoms_per_second(unsigned int nThreads, bool useRand) {
+    constexpr size_t nPerThread = 1000000;
+
+    atomic<unsigned long long> sink{0};
+    auto                       start = chrono::steady_clock::now();
+
+    vector<thread> threads;
+    for (unsigned int t = 0; t < nThreads; ++t)
+        threads.emplace_back([t, useRand, &sink]() {
+            OptRandom          random(0, t);
+            unsigned long long sum{0};
+            for (size_t i = 0; i < nPerThread; ++i)
+                sum += useRand ? (unsigned long long)rand() : random.next();
+            sink += sum;
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    return nThreads * nPerThread / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+//neighbours proposed per second in d dimensions, drawing the random numbers in bulk or per dimension
+double neighbours_per_second(size_t d, bool bulk) {
+    constexpr size_t n = 2000;
+
+    OptBoundaries<double> optBoundaries;
+    for (size_t i = 0; i < d; ++i)
+        optBoundaries.add_boundary({-5.0, 5.0, "X" + to_string(i)});
+
+    OptRandom random(0);
+    auto      reference = OptHelper<double>::random_calculation(optBoundaries, random);
+    auto      neighbour = reference;
+    double    sum{0};
+    auto      start = chrono::steady_clock::now();
+
+    for (size_t k = 0; k < n; ++k) {
+        random.next_evaluation();
+        if (bulk)
+            neighbour = OptHelper<double>::random_neighbour(reference, optBoundaries, 0.5, random);
+        else
+            for (size_t i = 0; i < d; ++i)
+                neighbour.set_parameter(i, reference.get_parameter(i) + OptHelper<double>::calculate_random_change(0.5, random));
+        sum += neighbour.get_parameter(d - 1);
+    }
+
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return sum == 0.123 ? 0 : n / seconds;
+}
+
+//nanoseconds per lookup within nRegions taboo regions in d dimensions
+double taboo_lookup_ns(size_t nRegions, size_t d) {
+    constexpr size_t n = 200000;
+
+    OptBoundaries<double> optBoundaries;
+    for (size_t i = 0; i < d; ++i)
+        optBoundaries.add_boundary({0.0, 1.0, "X" + to_string(i)});
+
+    OptTaboo<double> taboo(optBoundaries);
+    OptRandom        random(0);
+    vector<double>   values(d);
+
+    for (size_t k = 0; k < nRegions; ++k) {
+        random.fill_uniform(values.data(), d);
+        taboo.add(values.data(), 0.001 + 0.01 * random.uniform<double>());
+    }
+
+    size_t nInside{0};
+    auto   start = chrono::steady_clock::now();
+
+    for (size_t k = 0; k < n; ++k) {
+        random.fill_uniform(values.data(), d);
+        nInside += taboo.contains(values.data());
+    }
+
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return nInside == n + 1 ? 0 : seconds * 1e9 / n;
+}
+
 double n_times(int times, std::function<double(void)> const& f) {
     double sum{0};
     for (int i = 0; i < times; ++i)
@@ -177,6 +343,12 @@ double n_times(int times, std::function<double(void)> const& f) {
     return sum / times;
 }
 
+double allocations_per_calculation(unsigned int maxCalculations, std::function<double(void)> const& f) {
+    size_t before = nAllocations;
+    f();
+    return (nAllocations - before) / (double)maxCalculations;
+}
+
 int main() {
     constexpr int times = 10;
     cout << "All times in seconds" << endl;
@@ -184,5 +356,21 @@ int main() {
     cout << "time_sa_2() :\t " << n_times(times, time_sa_2) << endl;
     cout << "time_sa_3() :\t " << n_times(times, time_sa_3) << endl;
     cout << "time_sa_4() :\t " << n_times(times, time_sa_4) << endl;
+    cout << "time_sa_5() :\t " << n_times(times, time_sa_5) << endl;
+    cout << "time_sa_contention() :\t " << n_times(times, time_sa_contention) << endl;
+    cout << "random numbers per second" << endl;
+    cout << "rand() 1 thread :\t " << randoms_per_second(1, true) << endl;
+    cout << "rand() 32 threads :\t " << randoms_per_second(32, true) << endl;
+    cout << "OptRandom 1 thread :\t " << randoms_per_second(1, false) << endl;
+    cout << "OptRandom 32 threads :\t " << randoms_per_second(32, false) << endl;
+    cout << "neighbours per second, d = 1000" << endl;
+    cout << "per dimension :\t " << neighbours_per_second(1000, false) << endl;
+    cout << "bulk :\t " << neighbours_per_second(1000, true) << endl;
+    cout << "nanoseconds per taboo lookup, 50000 regions" << endl;
+    cout << "d = 2 :\t " << taboo_lookup_ns(50000, 2) << endl;
+    cout << "d = 4 :\t " << taboo_lookup_ns(50000, 4) << endl;
+    cout << "allocations per calculation" << endl;
+    cout << "time_sa_1() :\t " << allocations_per_calculation(30000, time_sa_1) << endl;
+    cout << "time_sa_5() :\t " << allocations_per_calculation(30000, time_sa_5) << endl;
     return 0;
 }
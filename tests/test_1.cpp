@@ -14,7 +14,14 @@
 #define CATCH_CONFIG_MAIN
 #include "../dependencies/Catch.h"  //https://github.com/philsquared/Catch
 
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <tuple>
 #include <vector>
 
 #include "cppOpt.h"
@@ -85,6 +92,1334 @@ TEST_CASE("Boundaries") {
             }
         }
     }
+
+    SECTION("Splitting into cells") {
+        OptBoundaries<double> optBoundaries;
+
+        optBoundaries.add_boundary({0.0, 10.0, "x"});
+        optBoundaries.add_boundary({0.0, 10.0, "y", OptTransform::LINEAR, OptBoundaryPolicy::REFLECT});
+        optBoundaries.add_boundary({1.0, 1000.0, "z", OptTransform::LOG});
+
+        auto grid = optBoundaries.split({"x", "y", "z"}, 30, OptSplit::GRID);
+        REQUIRE(grid.size() == 27);
+
+        //the cells cover the whole volume without overlapping
+        double volume{0};
+        for (auto const& cell : grid) {
+            volume += (cell.max(0) - cell.min(0)) * (cell.max(1) - cell.min(1)) * (log(cell.max(2)) - log(cell.min(2)));
+            REQUIRE((&cell.get_boundaries() == &optBoundaries));
+        }
+        REQUIRE(fabs(volume - 100.0 * log(1000.0)) < 1e-9);
+
+        //the logarithmic parameter is split evenly in its transformed space
+        REQUIRE(fabs(grid[0].max(2) - 10.0) < 1e-9);
+        REQUIRE(grid[0].min(2) == 1.0);
+
+        auto kd = optBoundaries.split({"x", "y"}, 6, OptSplit::KD);
+        REQUIRE(kd.size() == 6);
+
+        size_t nContaining{0};
+        for (auto const& cell : kd) {
+            REQUIRE(cell.max(2) == 1000.0);
+            nContaining += cell.contains(array<double, 3>{{2.5, 7.5, 5.0}}.data());
+        }
+        REQUIRE(nContaining == 1);
+
+        //materialized cells keep names, transforms and policies
+        auto boundaries = kd[5].to_boundaries();
+        REQUIRE(boundaries.size() == 3);
+        REQUIRE(boundaries.min(0) == kd[5].min(0));
+        REQUIRE(boundaries.max(1) == kd[5].max(1));
+        REQUIRE(boundaries.transform(2) == OptTransform::LOG);
+        REQUIRE(boundaries.policy(1) == OptBoundaryPolicy::REFLECT);
+        REQUIRE(boundaries.begin()->second.min == kd[5].min(0));
+    }
+
+    SECTION("Kernels") {
+        OptBoundaries<double> optBoundaries;
+
+        optBoundaries.add_boundary({0.0, 10.0, "x"});
+        optBoundaries.add_boundary({-2.0, 2.0, "y"});
+
+        REQUIRE(optBoundaries.range(1) == 4.0);
+        REQUIRE(optBoundaries.inv_range(1) == 0.25);
+
+        double        candidates[] = {5.0, 0.0, 11.0, 1.0, 3.0, -3.0};
+        unsigned char valid[3];
+
+        optBoundaries.valid(candidates, 3, valid);
+        REQUIRE(valid[0]);
+        REQUIRE(!valid[1]);
+        REQUIRE(!valid[2]);
+
+        optBoundaries.clamp(candidates, 3);
+        REQUIRE(candidates[2] == 10.0);
+        REQUIRE(candidates[5] == -2.0);
+
+        double unit[2], user[2];
+        optBoundaries.normalize(candidates, unit);
+        REQUIRE(unit[0] == 0.5);
+        REQUIRE(unit[1] == 0.5);
+
+        optBoundaries.scale(unit, user);
+        REQUIRE(user[0] == 5.0);
+        REQUIRE(user[1] == 0.0);
+
+        //-3.0 + 1.0 * 2.1 rounds above -0.9
+        OptBoundaries<double> rounding;
+        rounding.add_boundary({-3.0, -0.9, "x"});
+
+        double edge[] = {1.0}, onEdge[1];
+        rounding.to_user(edge, onEdge);
+        REQUIRE(onEdge[0] == -0.9);
+        REQUIRE(rounding.valid(onEdge));
+    }
+
+    SECTION("Transforms") {
+        OptBoundaries<double> optBoundaries;
+
+        REQUIRE_THROWS(optBoundaries.add_boundary({0.0, 1.0, "x", OptTransform::LOG}));
+        REQUIRE_THROWS(optBoundaries.add_boundary({0.5, 1.0, "y", OptTransform::LOGIT}));
+
+        optBoundaries.add_boundary({1e-6, 1e2, "x", OptTransform::LOG});
+        optBoundaries.add_boundary({0.01, 0.99, "y", OptTransform::LOGIT});
+
+        double unit[] = {0.0, 0.5}, user[2], back[2];
+        optBoundaries.to_user(unit, user);
+        REQUIRE(fabs(user[0] - 1e-6) < 1e-12);
+        REQUIRE(fabs(user[1] - 0.5) < 1e-12);
+
+        unit[0] = 0.75;
+        optBoundaries.to_user(unit, user);
+        REQUIRE(fabs(user[0] - 1.0) < 1e-9);
+
+        optBoundaries.to_unit(user, back);
+        REQUIRE(fabs(back[0] - 0.75) < 1e-12);
+        REQUIRE(fabs(back[1] - 0.5) < 1e-12);
+    }
+}
+
+TEST_CASE("Calculation") {
+    OptBoundaries<double> optBoundaries;
+    optBoundaries.add_boundary({0.0, 10.0, "y"});
+    optBoundaries.add_boundary({0.0, 10.0, "x"});
+
+    SECTION("Schema") {
+        REQUIRE(optBoundaries.get_schema()->size() == 2);
+        REQUIRE(optBoundaries.index_of("x") == 0);
+        REQUIRE(optBoundaries.index_of("y") == 1);
+    }
+
+    SECTION("Index and name access") {
+        OptCalculation<double> optCalculation(optBoundaries.get_schema());
+        const auto             y = optBoundaries.index_of("y");
+
+        optCalculation.set_parameter(y, 3.0);
+        optCalculation.add_parameter("x", 2.0);
+
+        REQUIRE(optCalculation.get_parameter("y") == 3.0);
+        REQUIRE(optCalculation.get_parameter(y) == 3.0);
+        REQUIRE(optCalculation.get_parameter("x") == 2.0);
+        REQUIRE(optCalculation.get_parameters().size() == 2);
+    }
+
+    SECTION("Distance") {
+        OptCalculation<double> a(optBoundaries.get_schema());
+        OptCalculation<double> b;
+
+        a.add_parameter("x", 3.0);
+        b.add_parameter("y", 4.0);
+        b.add_parameter("x", 0.0);
+
+        REQUIRE(a.using_same_parameters(b));
+        REQUIRE(fabs(a.distance_to(b) - 5.0) < DELTA);
+        REQUIRE(fabs(a.calculation_between(b).get_parameter("x") - 1.5) < DELTA);
+    }
+}
+
+TEST_CASE("History") {
+    OptBoundaries<double> optBoundaries;
+    optBoundaries.add_boundary({-5.0, 5.0, "X"});
+
+    OptHistory<double> history;
+    for (double x : {2.0, -1.0, 4.0, -1.0}) {
+        OptCalculation<double> optCalculation(optBoundaries.get_schema());
+        optCalculation.set_parameter(0, x);
+        optCalculation.result = x;
+        history.push_back(optCalculation, 7, history.size());
+    }
+
+    REQUIRE(history.size() == 4);
+    REQUIRE(history.column(0)[2] == 4.0);
+    REQUIRE(history.back().get_parameter("X") == -1.0);
+    REQUIRE(history.get_child_ids()[1] == 7);
+    REQUIRE(history.get_sequence_numbers()[3] == 3);
+
+    REQUIRE(history.index_best(OptTarget::MINIMIZE, 0.0) == 1);
+    REQUIRE(history.index_best(OptTarget::MAXIMIZE, 0.0) == 2);
+    REQUIRE(history.index_best(OptTarget::APPROACH, 2.5) == 0);
+    REQUIRE(history.index_best(OptTarget::DIVERGE, 3.0) == 1);
+
+    REQUIRE((history.indices_best(3, OptTarget::MINIMIZE, 0.0) == vector<size_t>{1, 3, 0}));
+}
+
+TEST_CASE("Archive") {
+    OptBoundaries<double> optBoundaries;
+    optBoundaries.add_boundary({-5.0, 5.0, "X"});
+
+    auto add_all = [&optBoundaries](OptArchive<double>& archive) {
+        for (double x : {2.0, -1.0, 4.0, -1.0, 3.0}) {
+            OptCalculation<double> optCalculation(optBoundaries.get_schema());
+            optCalculation.set_parameter(0, x);
+            optCalculation.result = x;
+            archive.add(optCalculation);
+        }
+    };
+
+    auto results = [](OptArchive<double> const& archive) {
+        vector<double> out;
+        for (auto const& optCalculation : archive.get_calculations())
+            out.push_back(optCalculation.result);
+        return out;
+    };
+
+    SECTION("All") {
+        OptArchive<double> archive(OptArchivePolicy::ALL, OptTarget::MINIMIZE, 0);
+        add_all(archive);
+        REQUIRE(archive.size() == 5);
+        REQUIRE(archive.get_best()->result == -1.0);
+        REQUIRE((results(archive) == vector<double>{2.0, -1.0, 4.0, -1.0, 3.0}));
+    }
+
+    SECTION("Best") {
+        OptArchive<double> archive(OptArchivePolicy::BEST, OptTarget::MAXIMIZE, 0, 2);
+        add_all(archive);
+        REQUIRE(archive.n_added() == 5);
+        REQUIRE(archive.get_best()->result == 4.0);
+        REQUIRE((results(archive) == vector<double>{4.0, 3.0}));
+    }
+
+    SECTION("Last") {
+        OptArchive<double> archive(OptArchivePolicy::LAST, OptTarget::MINIMIZE, 0, 3);
+        add_all(archive);
+        REQUIRE((results(archive) == vector<double>{4.0, -1.0, 3.0}));
+    }
+
+    SECTION("File") {
+        {
+            OptArchive<double> archive(OptArchivePolicy::FILE, OptTarget::MINIMIZE, 0, 0, "archive_test.txt");
+            add_all(archive);
+            REQUIRE(archive.size() == 0);
+            REQUIRE(archive.get_best()->result == -1.0);
+        }
+
+        ifstream file("archive_test.txt");
+        string   line;
+        getline(file, line);
+        REQUIRE(line == "X RESULT");
+
+        size_t nLines{0};
+        while (getline(file, line))
+            ++nLines;
+        REQUIRE(nLines == 5);
+
+        file.close();
+        remove("archive_test.txt");
+    }
+
+    SECTION("Coordinator") {
+        OptCoordinator<double, false> coordinator(
+            300,
+            toOptimize,
+            OptTarget::MINIMIZE,
+            0);
+
+        coordinator.add_child(make_unique<OptSimulatedAnnealing<double>>(
+            optBoundaries,
+            0.95,
+            0.25));
+
+        coordinator.set_archive(OptArchivePolicy::BEST, 10);
+        coordinator.run_optimisation();
+
+        REQUIRE(coordinator.get_archive().n_added() == 300);
+        REQUIRE(coordinator.get_archive().size() == 10);
+        REQUIRE(coordinator.get_archive().get_best()->result == coordinator.get_best_calculation().result);
+    }
+
+    SECTION("Coordinator multi threaded") {
+        atomic<size_t> nCalculations{0};
+
+        OptCoordinator<double, true> coordinator(
+            1000,
+            [&nCalculations](OptCalculation<double>& optCalculation) {
+                ++nCalculations;
+                toOptimize(optCalculation);
+            },
+            OptTarget::MINIMIZE,
+            0);
+
+        for (int i = 0; i < 4; ++i)
+            coordinator.add_child(make_unique<OptSimulatedAnnealing<double>>(
+                optBoundaries,
+                0.95,
+                0.25));
+
+        coordinator.set_archive(OptArchivePolicy::ALL);
+        coordinator.run_optimisation(4);
+
+        //the blocks buffered by the workers are all passed on, numbered in the order they reached the archive
+        auto const& history = coordinator.get_archive().get_history();
+        REQUIRE(history.size() == nCalculations.load());
+        for (size_t i = 0; i < history.size(); ++i)
+            REQUIRE(history.get_sequence_numbers()[i] == i);
+
+        REQUIRE(coordinator.get_best_calculation().result == coordinator.get_archive().get_best()->result);
+        REQUIRE(coordinator.get_best_calculation().result == history[history.index_best(OptTarget::MINIMIZE, 0)].result);
+    }
+}
+
+TEST_CASE("Random") {
+    SECTION("Streams") {
+        OptRandom
+            a(42, 0),
+            b(42, 0),
+            c(42, 1);
+
+        size_t
+            nEqualSame{0},
+            nEqualOther{0};
+
+        for (int i = 0; i < 100; ++i) {
+            auto x = a.next();
+            nEqualSame += x == b.next();
+            nEqualOther += x == c.next();
+        }
+        REQUIRE(nEqualSame == 100);
+        REQUIRE(nEqualOther == 0);
+    }
+
+    SECTION("Philox") {
+        //known answers of the reference implementation
+        REQUIRE((OptRandom::philox({{0, 0, 0, 0}}, {{0, 0}}) == array<uint32_t, 4>{{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}}));
+        REQUIRE((OptRandom::philox({{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}}, {{0xa4093822, 0x299f31d0}}) == array<uint32_t, 4>{{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}));
+    }
+
+    SECTION("Seeking") {
+        OptRandom
+            sequential(42, 3),
+            seeking(42, 3);
+
+        for (uint64_t evaluation = 0; evaluation < 10; ++evaluation) {
+            sequential.seek(evaluation);
+            for (int i = 0; i < 7; ++i)
+                sequential.next();
+        }
+        sequential.next_evaluation();
+
+        seeking.seek(10);
+        REQUIRE(sequential.get_evaluation() == 10);
+        REQUIRE(sequential.next() == seeking.next());
+    }
+
+    SECTION("Uniform") {
+        OptRandom random(7);
+        double    sum{0};
+        size_t    nOutside{0};
+
+        for (int i = 0; i < 10000; ++i) {
+            double x = random.uniform<double>();
+            nOutside += x < 0.0 || x >= 1.0;
+            sum += x;
+        }
+        REQUIRE(nOutside == 0);
+        REQUIRE(fabs(sum / 10000 - 0.5) < 0.02);
+    }
+
+    SECTION("Bulk") {
+        OptRandom
+            bulk(42, 3),
+            single(42, 3);
+
+        //starting in the middle of a block, so the buffered words have to be used up first
+        bulk.next32();
+        single.next32();
+
+        vector<uint32_t> words(1001);
+        bulk.fill(words.data(), words.size());
+
+        size_t nDifferent{0};
+        for (auto word : words)
+            nDifferent += word != single.next32();
+        REQUIRE(nDifferent == 0);
+
+        vector<double> uniforms(333);
+        bulk.fill_uniform(uniforms.data(), uniforms.size());
+        for (auto uniform : uniforms)
+            nDifferent += uniform != single.uniform<double>();
+        REQUIRE(nDifferent == 0);
+        REQUIRE(bulk.next() == single.next());
+
+        vector<double> normals(10001);
+        bulk.fill_normal(normals.data(), normals.size());
+
+        double sum{0}, sumSquares{0};
+        for (auto normal : normals) {
+            sum += normal;
+            sumSquares += normal * normal;
+        }
+        REQUIRE(fabs(sum / normals.size()) < 0.05);
+        REQUIRE(fabs(sumSquares / normals.size() - 1.0) < 0.05);
+    }
+
+    SECTION("Bulk neighbours") {
+        OptBoundaries<double> optBoundaries;
+        for (int i = 0; i < 100; ++i)
+            optBoundaries.add_boundary({0.0, 1.0, "X" + to_string(i)});
+
+        OptRandom
+            bulk(42),
+            single(42);
+
+        auto reference = OptHelper<double>::random_calculation(optBoundaries, bulk);
+        REQUIRE(reference.get_parameter(size_t(99)) == OptHelper<double>::random_calculation(optBoundaries, single).get_parameter(size_t(99)));
+
+        //the same as drawing the change of every dimension on its own
+        auto   neighbour = OptHelper<double>::random_neighbour(reference, optBoundaries, 0.3, bulk);
+        size_t nDifferent{0};
+        for (size_t i = 0; i < reference.size(); ++i)
+            nDifferent += neighbour.get_parameter(i) != reference.get_parameter(i) + OptHelper<double>::calculate_random_change(0.3, single);
+        REQUIRE(nDifferent == 0);
+    }
+
+    SECTION("Reproducible multithreading") {
+        OptBoundaries<double> optBoundaries;
+        optBoundaries.add_boundary({-5.0, 5.0, "X"});
+
+        auto run = [&optBoundaries]() {
+            OptCoordinator<double, true> coordinator(
+                400,
+                toOptimize,
+                OptTarget::MINIMIZE,
+                0);
+
+            for (int i = 0; i < 4; ++i)
+                coordinator.add_child(make_unique<OptSimulatedAnnealing<double>>(
+                    optBoundaries,
+                    0.95,
+                    0.25));
+
+            coordinator.set_seed(1337);
+            coordinator.run_optimisation(4);
+            return coordinator.get_best_calculation().get_parameter("X");
+        };
+
+        REQUIRE(run() == run());
+    }
+}
+
+TEST_CASE("Initial designs") {
+    SECTION("Sobol") {
+        OptSobol sobol(42);
+
+        //every dimension on its own has exactly one of the first 64 points in every interval of width 1/64
+        size_t nMissed{0};
+        for (size_t d = 0; d < sobol.max_dimensions(); ++d) {
+            array<int, 64> counts{};
+            for (uint64_t i = 0; i < 64; ++i)
+                ++counts[size_t(sobol.coordinate(i, d) * 64)];
+            for (auto count : counts)
+                nMissed += count != 1;
+        }
+        REQUIRE(nMissed == 0);
+
+        //the first two dimensions have one of the first 16 points in every cell of a 4x4 grid
+        array<int, 16> cells{};
+        for (uint64_t i = 0; i < 16; ++i)
+            ++cells[size_t(sobol.coordinate(i, 0) * 4) * 4 + size_t(sobol.coordinate(i, 1) * 4)];
+        for (auto cell : cells)
+            nMissed += cell != 1;
+        REQUIRE(nMissed == 0);
+
+        //different seeds scramble differently
+        REQUIRE(OptSobol(1).coordinate(5, 3) != OptSobol(2).coordinate(5, 3));
+        REQUIRE_THROWS(sobol.coordinate(0, sobol.max_dimensions()));
+    }
+
+    SECTION("Halton") {
+        OptHalton halton(42, 8);
+        REQUIRE(halton.max_dimensions() == 8);
+
+        //base 2 in the first dimension
+        array<int, 8> counts{};
+        for (uint64_t i = 0; i < 8; ++i) {
+            const double x = halton.coordinate(i, 0);
+            REQUIRE((x >= 0.0 && x < 1.0));
+            ++counts[size_t(x * 8)];
+        }
+        for (auto count : counts)
+            REQUIRE(count == 1);
+
+        REQUIRE_THROWS(halton.coordinate(0, 8));
+    }
+
+    SECTION("Coordinator") {
+        OptBoundaries<double> optBoundaries;
+        optBoundaries.add_boundary({-5.0, 5.0, "X"});
+
+        OptCoordinator<double, false> coordinator(
+            400,
+            toOptimize,
+            OptTarget::MINIMIZE,
+            0);
+
+        for (int i = 0; i < 4; ++i)
+            coordinator.add_child(make_unique<OptSimulatedAnnealing<double>>(
+                optBoundaries,
+                0.95,
+                0.25));
+
+        coordinator.set_initial_design(make_unique<OptSobol>(7));
+        coordinator.set_archive(OptArchivePolicy::ALL);
+        coordinator.run_optimisation();
+
+        //the children start at the first four points of the design, one per quarter
+        auto const&    history = coordinator.get_archive().get_history();
+        array<int, 4>  quarters{};
+        vector<size_t> firstIndex(4, history.size());
+
+        for (size_t i = 0; i < history.size(); ++i)
+            if (firstIndex[history.get_child_ids()[i]] == history.size())
+                firstIndex[history.get_child_ids()[i]] = i;
+
+        for (size_t child = 0; child < 4; ++child) {
+            const double x = history.column(0)[firstIndex[child]];
+            REQUIRE(x == -5.0 + 10.0 * OptSobol(7).coordinate(child, 0));
+            ++quarters[size_t((x + 5.0) / 2.5)];
+        }
+        for (auto quarter : quarters)
+            REQUIRE(quarter == 1);
+
+        REQUIRE(fabs(coordinator.get_best_calculation().result - 0.0) < DELTA);
+    }
+}
+
+TEST_CASE("Boundary policies") {
+    OptRandom random(42);
+
+    auto nInvalid = [&random](OptBoundaryPolicy policy) {
+        OptBoundaries<double> optBoundaries;
+        optBoundaries.add_boundary({-5.0, 5.0, "X", OptTransform::LINEAR, policy});
+        optBoundaries.add_boundary({0.0, 1.0, "Y", OptTransform::LINEAR, policy});
+
+        OptCalculation<double> reference(optBoundaries.get_schema());
+        reference.set_parameter(size_t(0), 0.99);
+        reference.set_parameter(size_t(1), 0.01);
+
+        size_t n{0};
+        for (int i = 0; i < 1000; ++i) {
+            random.next_evaluation();
+            n += !OptHelper<double>::valid(OptHelper<double>::random_neighbour(reference, optBoundaries, 1.0, random), optBoundaries);
+        }
+        return n;
+    };
+
+    SECTION("Single pass") {
+        REQUIRE(nInvalid(OptBoundaryPolicy::REJECT) > 0);
+        REQUIRE(nInvalid(OptBoundaryPolicy::REFLECT) == 0);
+        REQUIRE(nInvalid(OptBoundaryPolicy::CLAMP) == 0);
+        REQUIRE(nInvalid(OptBoundaryPolicy::WRAP) == 0);
+        REQUIRE(nInvalid(OptBoundaryPolicy::TRUNCATE) == 0);
+    }
+
+    SECTION("Retry rate") {
+        OptBoundaries<double> optBoundaries;
+        optBoundaries.add_boundary({0.0, 5.0, "X"});
+
+        OptCoordinator<double, false> coordinator(
+            1000,
+            toOptimize,
+            OptTarget::MINIMIZE,
+            0);
+
+        auto child  = make_unique<OptSimulatedAnnealing<double>>(optBoundaries, 0.95, 0.25);
+        auto sa     = child.get();
+        coordinator.add_child(move(child));
+        coordinator.run_optimisation();
+
+        //the minimum is at the boundary, so many proposals leave it
+        REQUIRE(sa->get_retries().nProposals > 0);
+        REQUIRE(sa->get_retries().rate() > 0.0);
+    }
+
+    SECTION("Reflecting at the optimum") {
+        OptBoundaries<double> optBoundaries;
+        optBoundaries.add_boundary({0.0, 5.0, "X", OptTransform::LINEAR, OptBoundaryPolicy::REFLECT});
+
+        OptCoordinator<double, false> coordinator(
+            1000,
+            toOptimize,
+            OptTarget::MINIMIZE,
+            0);
+
+        auto child = make_unique<OptSimulatedAnnealing<double>>(optBoundaries, 0.95, 0.25);
+        auto sa    = child.get();
+        coordinator.add_child(move(child));
+        coordinator.run_optimisation();
+
+        REQUIRE(sa->get_retries().rate() == 0.0);
+        REQUIRE(fabs(coordinator.get_best_calculation().result - 0.0) < DELTA);
+    }
+}
+
+TEST_CASE("Warm-up") {
+    OptBoundaries<double> optBoundaries;
+    optBoundaries.add_boundary({-5.0, 5.0, "X"});
+
+    auto run = [&optBoundaries](unsigned int nThreads, OptHistory<double>* history) {
+        OptCoordinator<double, true> coordinator(
+            400,
+            toOptimize,
+            OptTarget::MINIMIZE,
+            0);
+
+        for (int i = 0; i < 3; ++i)
+            coordinator.add_child(make_unique<OptSimulatedAnnealing<double>>(
+                optBoundaries,
+                0.95,
+                0.25));
+
+        coordinator.add_child(make_unique<OptEvolutionary<double>>(
+            optBoundaries,
+            OptTarget::MINIMIZE,
+            0,
+            0.95,
+            30,
+            10,
+            20,
+            0.1));
+
+        coordinator.set_seed(1337);
+        coordinator.enable_deterministic();
+        coordinator.enable_warm_up(64);
+        coordinator.set_archive(OptArchivePolicy::ALL);
+        coordinator.run_optimisation(nThreads);
+
+        if (history)
+            *history = coordinator.get_archive().get_history();
+
+        auto best = coordinator.get_best_calculation();
+        return make_pair(best.get_parameter("X"), best.result);
+    };
+
+    OptHistory<double> history;
+    const auto         single = run(1, &history);
+
+    REQUIRE(fabs(single.second - 0.0) < DELTA);
+    REQUIRE(run(4, nullptr) == single);
+
+    //the first 16 points of every child, one in each sixteenth of the range
+    array<array<int, 16>, 4> counts{};
+    array<size_t, 4>         nSeen{};
+
+    for (size_t i = 0; i < history.size(); ++i) {
+        const size_t child = history.get_child_ids()[i];
+        if (nSeen[child]++ < 16)
+            ++counts[child][size_t((history.column(0)[i] + 5.0) / 10.0 * 16)];
+    }
+
+    size_t nMissed{0};
+    for (auto const& countsChild : counts)
+        for (auto count : countsChild)
+            nMissed += count != 1;
+    REQUIRE(nMissed == 0);
+}
+
+TEST_CASE("Adaptive partitioning") {
+    OptBoundaries<double> optBoundaries;
+    optBoundaries.add_boundary({-50.0, 50.0, "X"});
+    optBoundaries.add_boundary({-50.0, 50.0, "Y"});
+
+    auto toOptimize2 = [](OptCalculation<double>& optCalculation) {
+        optCalculation.result = pow(optCalculation.get_parameter(size_t(0)) - 3.0, 2) + pow(optCalculation.get_parameter(size_t(1)) + 7.0, 2);
+    };
+
+    auto spawn = [](OptBoundaries<double> const& boundaries) {
+        return make_unique<OptSimulatedAnnealing<double>>(boundaries, 0.95, 0.25);
+    };
+
+    auto run = [&](unsigned int nThreads) {
+        atomic<size_t> nCalculations{0};
+
+        OptCoordinator<double, true> coordinator(
+            4000,
+            [&nCalculations, &toOptimize2](OptCalculation<double>& optCalculation) {
+                ++nCalculations;
+                toOptimize2(optCalculation);
+            },
+            OptTarget::MINIMIZE,
+            0);
+
+        for (auto const& cell : optBoundaries.split({"X", "Y"}, 16))
+            coordinator.add_child(spawn(cell.to_boundaries()));
+
+        coordinator.enable_adaptive_partitioning(spawn, 200, 64);
+        coordinator.run_optimisation(nThreads);
+
+        //the budget of retired children is spent on the new ones, the total stays the same
+        REQUIRE(coordinator.get_number_of_children() > 16);
+        REQUIRE(coordinator.get_number_of_children() <= 64);
+        REQUIRE(nCalculations <= 16u * (4000u / 16u + 1u));
+        REQUIRE(fabs(coordinator.get_best_calculation().result - 0.0) < DELTA);
+    };
+
+    SECTION("Single threaded") {
+        run(1);
+    }
+
+    SECTION("Multi threaded") {
+        run(4);
+    }
+}
+
+TEST_CASE("Adaptive partitioning of equal children") {
+    OptBoundaries<double> optBoundaries;
+    optBoundaries.add_boundary({-50.0, 50.0, "X"});
+    optBoundaries.add_boundary({-50.0, 50.0, "Y"});
+
+    auto spawn = [](OptBoundaries<double> const& boundaries) {
+        return make_unique<OptSimulatedAnnealing<double>>(boundaries, 0.95, 0.25);
+    };
+
+    OptCoordinator<double, false> coordinator(
+        4000,
+        [](OptCalculation<double>& optCalculation) { optCalculation.result = 1.0; },
+        OptTarget::MINIMIZE,
+        0);
+
+    for (auto const& cell : optBoundaries.split({"X", "Y"}, 16))
+        coordinator.add_child(spawn(cell.to_boundaries()));
+
+    coordinator.set_seed(1337);
+    coordinator.enable_adaptive_partitioning(spawn, 200, 64);
+    coordinator.run_optimisation();
+
+    //none of them is clearly inferior, so none is retired and no budget is freed for new children
+    REQUIRE(coordinator.get_number_of_children() == 16u);
+}
+
+TEST_CASE("Adaptive partitioning along several parameters") {
+    OptBoundaries<double> optBoundaries;
+    optBoundaries.add_boundary({-50.0, 50.0, "X"});
+    optBoundaries.add_boundary({-50.0, 50.0, "Y"});
+
+    //the narrowest width of both parameters among the spawned regions
+    array<double, 2> minWidths{100.0, 100.0};
+
+    auto spawn = [&minWidths](OptBoundaries<double> const& boundaries) {
+        for (size_t i = 0; i < 2; ++i)
+            minWidths[i] = std::min(minWidths[i], boundaries.range(i));
+        return make_unique<OptSimulatedAnnealing<double>>(boundaries, 0.95, 0.25);
+    };
+
+    OptCoordinator<double, false> coordinator(
+        4000,
+        [](OptCalculation<double>& optCalculation) {
+            optCalculation.result = pow(optCalculation.get_parameter(size_t(0)) - 3.0, 2) + pow(optCalculation.get_parameter(size_t(1)) + 7.0, 2);
+        },
+        OptTarget::MINIMIZE,
+        0);
+
+    //slabs along X, so they are widest along Y relative to the whole space
+    for (auto const& cell : optBoundaries.split({"X"}, 16))
+        coordinator.add_child(spawn(cell.to_boundaries()));
+
+    minWidths = {100.0, 100.0};  //only the spawned regions
+    coordinator.set_seed(1337);
+    coordinator.enable_adaptive_partitioning(spawn, 200, 64);
+    coordinator.run_optimisation();
+
+    //the regions are halved along Y, not only ever along the first parameter
+    REQUIRE(coordinator.get_number_of_children() > 16);
+    REQUIRE(minWidths[1] < 100.0 - DELTA);
+}
+
+TEST_CASE("Taboo regions") {
+    OptBoundaries<double> optBoundaries;
+    optBoundaries.add_boundary({-5.0, 5.0, "X"});
+    optBoundaries.add_boundary({-5.0, 5.0, "Y"});
+
+    SECTION("Lookup") {
+        //the index has to find the same regions as checking all of them
+        OptTaboo<double> taboo(optBoundaries);
+        OptRandom        random(1);
+        vector<double>   centers, radii;
+        array<double, 2> values;
+
+        size_t nMissed{0}, nInside{0};
+        for (size_t k = 0; k < 3000; ++k) {
+            for (auto& value : values)
+                value = -5.0 + 10.0 * random.uniform<double>();
+            const double radius = 0.001 + 0.02 * random.uniform<double>();
+
+            taboo.add(values.data(), radius);
+            centers.insert(centers.end(), values.begin(), values.end());
+            radii.push_back(radius);
+
+            for (size_t q = 0; q < 10; ++q) {
+                for (auto& value : values)
+                    value = -5.0 + 10.0 * random.uniform<double>();
+
+                bool inside{false};
+                for (size_t i = 0; i < radii.size() && !inside; ++i)
+                    inside = pow((values[0] - centers[2 * i]) / 10.0, 2) + pow((values[1] - centers[2 * i + 1]) / 10.0, 2) < radii[i] * radii[i];
+
+                nInside += inside;
+                nMissed += inside != taboo.contains(values.data());
+            }
+        }
+        REQUIRE(taboo.size() == 3000);
+        REQUIRE(nInside > 0);
+        REQUIRE(nMissed == 0);
+    }
+
+    auto run = [&](unsigned int nThreads, bool automatic) {
+        vector<array<double, 3>> calculated;
+        mutex                    mCalculated;
+
+        OptCoordinator<double, true> coordinator(
+            2000,
+            [&](OptCalculation<double>& optCalculation) {
+                optCalculation.result = pow(optCalculation.get_parameter(size_t(0)), 2) + pow(optCalculation.get_parameter(size_t(1)), 2);
+                lock_guard<mutex> lck(mCalculated);
+                calculated.push_back({optCalculation.get_parameter(size_t(0)), optCalculation.get_parameter(size_t(1)), optCalculation.result});
+            },
+            OptTarget::MINIMIZE,
+            0);
+
+        //a single child when automatic, since the first candidates of all children are asked before any result is known
+        for (auto const& cell : optBoundaries.split({"X", "Y"}, automatic ? 1 : 4))
+            coordinator.add_child(make_unique<OptSimulatedAnnealing<double>>(cell.to_boundaries(), 0.95, 0.25));
+
+        //the optimum itself is taboo
+        auto taboo = make_unique<OptTaboo<double>>(optBoundaries);
+        taboo->add(array<double, 2>{0.0, 0.0}.data(), 0.05);
+        coordinator.set_taboo(move(taboo));
+
+        if (automatic)
+            coordinator.enable_auto_taboo(20.0, 0.02);
+
+        coordinator.set_seed(3);
+        coordinator.run_optimisation(nThreads);
+
+        size_t nViolations{0};
+        for (size_t k = 0; k < calculated.size(); ++k) {
+            //the search converges onto the surface of the region, where the distances may round either way
+            if (hypot(calculated[k][0], calculated[k][1]) / 10.0 < 0.05 - 1e-9)
+                ++nViolations;
+
+            //single threaded, every poor result is taboo for all calculations after it
+            if (automatic && nThreads == 1)
+                for (size_t i = 0; i < k; ++i)
+                    if (calculated[i][2] > 20.0 && hypot(calculated[k][0] - calculated[i][0], calculated[k][1] - calculated[i][1]) / 10.0 < 0.02 - 1e-9)
+                        ++nViolations;
+        }
+
+        REQUIRE(nViolations == 0);
+        REQUIRE(coordinator.get_number_of_taboo_skips() > 0);
+        REQUIRE(calculated.size() <= 4 * (2000 / 4 + 1));
+        REQUIRE(coordinator.get_best_calculation().result > 0.25 - DELTA);
+
+        if (automatic)
+            REQUIRE(coordinator.get_taboo()->size() > 1);
+    };
+
+    SECTION("Declared") {
+        run(1, false);
+        run(4, false);
+    }
+
+    SECTION("Automatic") {
+        run(1, true);
+        run(4, true);
+    }
+}
+
+TEST_CASE("Feasibility") {
+    OptBoundaries<double> optBoundaries;
+    optBoundaries.add_boundary({0.0, 1.0, "X"});
+    optBoundaries.add_boundary({0.0, 1.0, "Y"});
+    optBoundaries.add_boundary({0.0, 1.0, "Z"});
+
+    //shares which must not sum up to more than 1
+    auto sum = [](OptCalculation<double> const& optCalculation) {
+        return optCalculation.get_parameter(size_t(0)) + optCalculation.get_parameter(size_t(1)) + optCalculation.get_parameter(size_t(2));
+    };
+
+    auto run = [&](unsigned int nThreads, bool repair) {
+        atomic<size_t> nCalculations{0}, nViolations{0};
+
+        OptCoordinator<double, true> coordinator(
+            2000,
+            [&](OptCalculation<double>& optCalculation) {
+                ++nCalculations;
+                if (sum(optCalculation) > 1.0 + 1e-9)
+                    ++nViolations;
+                optCalculation.result = optCalculation.get_parameter(size_t(0)) + 2.0 * optCalculation.get_parameter(size_t(1)) + 3.0 * optCalculation.get_parameter(size_t(2));
+            },
+            OptTarget::MAXIMIZE,
+            0);
+
+        for (size_t i = 0; i < 4; ++i)
+            coordinator.add_child(make_unique<OptSimulatedAnnealing<double>>(optBoundaries, 0.95, 0.25));
+
+        coordinator.set_feasibility([&sum, repair](OptCalculation<double>& optCalculation) {
+            const double total = sum(optCalculation);
+            if (total <= 1.0)
+                return true;
+            if (!repair)
+                return false;
+
+            for (size_t i = 0; i < 3; ++i)
+                optCalculation.set_parameter(i, optCalculation.get_parameter(i) / total);
+            return true;
+        });
+
+        coordinator.set_seed(5);
+        coordinator.run_optimisation(nThreads);
+
+        REQUIRE(nViolations == 0u);
+        REQUIRE(nCalculations > 0u);
+        REQUIRE(nCalculations <= 4u * (2000u / 4u + 1u));
+        REQUIRE(coordinator.get_infeasible().nProposals >= nCalculations);
+        REQUIRE(coordinator.get_best_calculation().result > 2.5);
+        REQUIRE(sum(coordinator.get_best_calculation()) <= 1.0 + 1e-9);
+
+        if (repair) {
+            REQUIRE(coordinator.get_infeasible().nRetries == 0);
+            REQUIRE(coordinator.get_number_of_repairs() > 0);
+        } else {
+            REQUIRE(coordinator.get_infeasible().nRetries > 0);
+            REQUIRE(coordinator.get_infeasible().rate() > 0.0);
+            REQUIRE(coordinator.get_number_of_repairs() == 0);
+        }
+    };
+
+    SECTION("Resampled") {
+        run(1, false);
+        run(4, false);
+    }
+
+    SECTION("Repaired") {
+        run(1, true);
+        run(4, true);
+    }
+
+    SECTION("Deterministic") {
+        //replacements use evaluations of their own and evolutionary only replaces from its current generation
+        auto runDeterministic = [&](unsigned int nThreads) {
+            OptCoordinator<double, true> coordinator(
+                2000,
+                [](OptCalculation<double>& optCalculation) {
+                    optCalculation.result = optCalculation.get_parameter(size_t(0)) + 2.0 * optCalculation.get_parameter(size_t(1)) + 3.0 * optCalculation.get_parameter(size_t(2));
+                },
+                OptTarget::MAXIMIZE,
+                0);
+
+            coordinator.add_child(make_unique<OptSimulatedAnnealing<double>>(optBoundaries, 0.95, 0.25));
+            coordinator.add_child(make_unique<OptEvolutionary<double>>(optBoundaries, OptTarget::MAXIMIZE, 0, 0.95, 30, 10, 20, 0.1));
+
+            coordinator.set_feasibility([&sum](OptCalculation<double>& optCalculation) { return sum(optCalculation) <= 1.0; });
+            coordinator.set_seed(5);
+            coordinator.set_candidates_per_child(4);
+            coordinator.enable_deterministic();
+            coordinator.run_optimisation(nThreads);
+
+            const auto infeasible = coordinator.get_infeasible();
+            REQUIRE(infeasible.nRetries > 0);
+
+            auto best = coordinator.get_best_calculation();
+            return make_tuple(best.result, best.get_parameter(size_t(0)), infeasible.nProposals, infeasible.nRetries);
+        };
+
+        REQUIRE(runDeterministic(1) == runDeterministic(4));
+    }
+}
+
+TEST_CASE("Discrete parameters") {
+    OptBoundaries<double> optBoundaries;
+    optBoundaries.add_boundary({-10.0, 10.0, "X", OptTransform::LINEAR, OptBoundaryPolicy::REJECT, OptKind::INTEGER});
+    optBoundaries.add_boundary({-10.0, 10.0, "Y", OptTransform::LINEAR, OptBoundaryPolicy::REFLECT, OptKind::INTEGER});
+    optBoundaries.add_boundary({0.0, 3.0, "Z", OptTransform::LINEAR, OptBoundaryPolicy::REJECT, OptKind::CATEGORICAL});
+
+    const size_t z = optBoundaries.index_of("Z");
+
+    SECTION("Mapping") {
+        REQUIRE(!optBoundaries.all_continuous());
+        REQUIRE(optBoundaries.levels(0) == 21.0);
+        REQUIRE(optBoundaries.levels(z) == 4.0);
+        REQUIRE_THROWS(optBoundaries.add_boundary({0.5, 3.0, "W", OptTransform::LINEAR, OptBoundaryPolicy::REJECT, OptKind::INTEGER}));
+        REQUIRE_THROWS(optBoundaries.add_boundary({1.0, 3.0, "W", OptTransform::LOG, OptBoundaryPolicy::REJECT, OptKind::INTEGER}));
+
+        //every value owns an equal slice of the unit interval
+        array<double, 3> unit{0.0, 0.999, 0.6}, user, back;
+        optBoundaries.to_user(unit.data(), user.data());
+        REQUIRE(user[0] == -10.0);
+        REQUIRE(user[1] == 10.0);
+        REQUIRE(user[z] == 2.0);
+
+        optBoundaries.to_unit(user.data(), back.data());
+        optBoundaries.snap(unit.data());
+        REQUIRE(back == unit);
+        REQUIRE(unit[0] == 0.5 / 21.0);
+
+        //cells split between the values, keeping them integral
+        auto cells = optBoundaries.split({"X"}, 3);
+        REQUIRE(cells.size() == 3);
+        REQUIRE(cells[0].min(0) == -10.0);
+        REQUIRE(cells[0].max(0) == -4.0);
+        REQUIRE(cells[1].min(0) == -3.0);
+        REQUIRE(cells[2].max(0) == 10.0);
+        REQUIRE(cells[2].to_boundaries().levels(0) == 7.0);
+    }
+
+    SECTION("Neighbours") {
+        OptRandom random(2);
+        auto      reference = OptHelper<double>::random_calculation(optBoundaries, random);
+        size_t    nSame{0}, nSwitched{0};
+
+        for (size_t k = 0; k < 2000; ++k) {
+            random.next_evaluation();
+            auto neighbour = OptHelper<double>::random_neighbour(reference, optBoundaries, 0.3, random);
+
+            nSame += OptBoundaries<double>::level(neighbour.get_parameter(size_t(0)), 21.0) == OptBoundaries<double>::level(reference.get_parameter(size_t(0)), 21.0);
+            nSwitched += OptBoundaries<double>::level(neighbour.get_parameter(z), 4.0) != OptBoundaries<double>::level(reference.get_parameter(z), 4.0);
+
+            //reflected, so always within the boundaries
+            REQUIRE(neighbour.get_parameter(size_t(1)) > 0.0);
+            REQUIRE(neighbour.get_parameter(size_t(1)) < 1.0);
+
+            auto snapped = neighbour;
+            optBoundaries.snap(snapped.data());
+            if (OptHelper<double>::valid(neighbour, optBoundaries))
+                for (size_t i = 0; i < 3; ++i)
+                    REQUIRE(snapped.get_parameter(i) == neighbour.get_parameter(i));
+        }
+
+        //integers mostly move but may stay, categories switch with the chance of the temperature
+        REQUIRE(nSame > 0);
+        REQUIRE(nSame < 1000);
+        REQUIRE(nSwitched > 400);
+        REQUIRE(nSwitched < 800);
+    }
+
+    auto run = [&](unsigned int nThreads) {
+        set<array<double, 3>> calculated;
+        size_t                nCalculations{0}, nDuplicates{0};
+        mutex                 mCalculated;
+
+        OptCoordinator<double, true> coordinator(
+            3000,
+            [&](OptCalculation<double>& optCalculation) {
+                array<double, 3> values{optCalculation.get_parameter(size_t(0)), optCalculation.get_parameter(size_t(1)), optCalculation.get_parameter(size_t(2))};
+                optCalculation.result = pow(values[0] - 3.0, 2) + pow(values[1] + 2.0, 2) + (values[z] == 2.0 ? 0.0 : 5.0);
+
+                lock_guard<mutex> lck(mCalculated);
+                ++nCalculations;
+                nDuplicates += !calculated.insert(values).second;
+            },
+            OptTarget::MINIMIZE,
+            0);
+
+        coordinator.add_child(make_unique<OptSimulatedAnnealing<double>>(optBoundaries, 0.95, 0.25));
+        coordinator.set_seed(5);
+        coordinator.run_optimisation(nThreads);
+
+        //there are just 21 * 21 * 4 configurations
+        REQUIRE(nDuplicates == 0);
+        REQUIRE(nCalculations <= 21 * 21 * 4);
+        REQUIRE(coordinator.get_number_of_duplicates() > 0);
+        for (auto const& values : calculated)
+            for (auto const& value : values)
+                REQUIRE(value == round(value));
+
+        auto best = coordinator.get_best_calculation();
+        REQUIRE(best.result == 0.0);
+        REQUIRE(best.get_parameter("Z") == 2.0);
+    };
+
+    SECTION("Single threaded") {
+        run(1);
+    }
+
+    SECTION("Multi threaded") {
+        run(4);
+    }
+}
+
+TEST_CASE("Conditional parameters") {
+    OptBoundaries<double> optBoundaries;
+    optBoundaries.add_boundary({0.0, 2.0, "solver", OptTransform::LINEAR, OptBoundaryPolicy::REJECT, OptKind::CATEGORICAL});
+    optBoundaries.add_boundary({0.0, 1.0, "A"});
+    optBoundaries.add_boundary({0.0, 10.0, "B", OptTransform::LINEAR, OptBoundaryPolicy::CLAMP, OptKind::INTEGER});
+    optBoundaries.add_boundary({0.0, 1.0, "C", OptTransform::LINEAR, OptBoundaryPolicy::REFLECT});
+
+    optBoundaries.set_condition("A", "solver", {1.0});
+    optBoundaries.set_condition("B", "solver", {2.0});
+    optBoundaries.set_condition("C", "B", {5.0, 6.0, 7.0, 8.0, 9.0, 10.0});
+
+    const size_t
+        a      = optBoundaries.index_of("A"),
+        b      = optBoundaries.index_of("B"),
+        c      = optBoundaries.index_of("C"),
+        solver = optBoundaries.index_of("solver");
+
+    array<double, 4> canonical, canonicalUser;
+    for (size_t i = 0; i < 4; ++i)
+        canonical[i] = optBoundaries.canonical(i);
+    optBoundaries.to_user(canonical.data(), canonicalUser.data());
+
+    SECTION("Conditions") {
+        REQUIRE(optBoundaries.has_conditions());
+        REQUIRE(canonicalUser[a] == 0.5);
+        REQUIRE(canonicalUser[b] == 5.0);
+        REQUIRE_THROWS(optBoundaries.set_condition("A", "X", {1.0}));
+        REQUIRE_THROWS(optBoundaries.set_condition("B", "A", {1.0}));
+        REQUIRE_THROWS(optBoundaries.set_condition("solver", "B", {1.0}));
+
+        array<double, 4> user, unit;
+        user[solver] = 2.0;
+        user[a]      = 0.9;
+        user[b]      = 3.0;
+        user[c]      = 0.1;
+        optBoundaries.to_unit(user.data(), unit.data());
+
+        //C requires B >= 5
+        REQUIRE(!optBoundaries.active(unit.data(), a));
+        REQUIRE(optBoundaries.active(unit.data(), b));
+        REQUIRE(!optBoundaries.active(unit.data(), c));
+
+        auto other = unit;
+        other[a]   = 0.1;
+        other[c]   = 0.9;
+        REQUIRE(optBoundaries.distance(unit.data(), other.data()) == 0.0);
+
+        optBoundaries.snap(unit.data());
+        REQUIRE(unit[a] == canonical[a]);
+        REQUIRE(unit[c] == canonical[c]);
+
+        //the whole subtree is inactive, even though B stays at a value activating C
+        user[solver] = 1.0;
+        user[b]      = 8.0;
+        optBoundaries.to_unit(user.data(), unit.data());
+        REQUIRE(!optBoundaries.active(unit.data(), c));
+
+        optBoundaries.snap(unit.data());
+        REQUIRE(unit[a] != canonical[a]);
+        REQUIRE(unit[b] == canonical[b]);
+        REQUIRE(unit[c] == canonical[c]);
+    }
+
+    SECTION("Neighbours") {
+        OptRandom random(3);
+        auto      reference = OptHelper<double>::random_calculation(optBoundaries, random);
+        size_t    nActive{0};
+
+        for (size_t k = 0; k < 2000; ++k) {
+            random.next_evaluation();
+            reference = OptHelper<double>::random_neighbour(reference, optBoundaries, 0.5, random);
+            if (!OptHelper<double>::valid(reference, optBoundaries))
+                reference = OptHelper<double>::random_calculation(optBoundaries, random);
+
+            for (auto i : {a, b, c}) {
+                if (optBoundaries.active(reference.data(), i))
+                    ++nActive;
+                else
+                    REQUIRE(reference.get_parameter(i) == canonical[i]);
+            }
+        }
+
+        REQUIRE(nActive > 0);
+    }
+
+    SECTION("Algorithms") {
+        for (int algorithm = 0; algorithm < 4; ++algorithm) {
+            size_t nViolations{0};
+            mutex  mViolations;
+
+            OptCoordinator<double, true> coordinator(
+                1000,
+                [&](OptCalculation<double>& optCalculation) {
+                    const double
+                        s  = optCalculation.get_parameter(solver),
+                        vA = optCalculation.get_parameter(a),
+                        vB = optCalculation.get_parameter(b),
+                        vC = optCalculation.get_parameter(c);
+
+                    const bool
+                        activeA = s == 1.0,
+                        activeB = s == 2.0,
+                        activeC = activeB && vB >= 5.0;
+
+                    if (s == 0.0)
+                        optCalculation.result = 5.0;
+                    else if (activeA)
+                        optCalculation.result = pow(vA - 0.3, 2) + 0.5;
+                    else
+                        optCalculation.result = 0.1 * pow(vB - 7.0, 2) + (activeC ? pow(vC - 0.2, 2) : 1.0);
+
+                    lock_guard<mutex> lck(mViolations);
+                    nViolations += (!activeA && vA != canonicalUser[a]) + (!activeB && vB != canonicalUser[b]) + (!activeC && vC != canonicalUser[c]);
+                },
+                OptTarget::MINIMIZE,
+                0);
+
+            switch (algorithm) {
+                case 0:
+                    coordinator.add_child(make_unique<OptSimulatedAnnealing<double>>(optBoundaries, 0.95, 0.25));
+                    break;
+
+                case 1:
+                    coordinator.add_child(make_unique<OptThresholdAccepting<double>>(optBoundaries, OptTarget::MINIMIZE, 0, 0.95, 5.0, 0.95));
+                    break;
+
+                case 2:
+                    coordinator.add_child(make_unique<OptGreatDeluge<double>>(optBoundaries, OptTarget::MINIMIZE, 0, 0.95, 10.0, 0.2));
+                    break;
+
+                default:
+                    coordinator.add_child(make_unique<OptEvolutionary<double>>(optBoundaries, OptTarget::MINIMIZE, 0, 0.95, 30, 10, 20, 0.1));
+                    break;
+            }
+
+            coordinator.set_seed(7);
+            coordinator.run_optimisation(2);
+
+            //every inactive parameter arrives at its canonical value
+            REQUIRE(nViolations == 0);
+            REQUIRE(coordinator.get_best_calculation().result < 1.0);
+        }
+    }
+}
+
+TEST_CASE("Queue") {
+    OptQueue<int> queue(3);
+    REQUIRE(queue.capacity() == 4);
+    REQUIRE(!queue.try_pop());
+
+    for (int i = 0; i < 4; ++i)
+        REQUIRE(queue.try_push(int(i)));
+    REQUIRE(!queue.try_push(4));
+
+    REQUIRE(*queue.try_pop() == 0);
+    REQUIRE(queue.try_push(4));
+
+    for (int i = 1; i < 5; ++i)
+        REQUIRE(*queue.try_pop() == i);
+    REQUIRE(!queue.try_pop());
+}
+
+TEST_CASE("Thread pool") {
+    SECTION("Spawning tasks") {
+        OptThreadPool<int> pool(4, 1024);
+        atomic<int>        nDone{0};
+
+        pool.push(0, 8);
+        pool.run([&](size_t worker, int depth) -> optional<int> {
+            ++nDone;
+            if (depth == 0)
+                return nullopt;
+            pool.push(worker, depth - 1);
+            return depth - 1;  //continued by the same worker
+        });
+
+        REQUIRE(nDone == 511);
+    }
+
+    SECTION("Stopping") {
+        OptThreadPool<int> pool(1, 16);
+        int                nDone{0};
+
+        for (int i = 0; i < 10; ++i)
+            pool.push(0, int(i));
+
+        pool.work(0, [&](size_t, int i) -> optional<int> {
+            ++nDone;
+            if (i == 4)
+                pool.stop();
+            return nullopt;
+        });
+
+        REQUIRE(nDone == 5);
+    }
+}
+
+TEST_CASE("Fixed number of parameters") {
+    using X = OptIndex<0>;
+
+    OptBoundaries<double, 1> optBoundaries;
+    optBoundaries.add_boundary({-5.0, 5.0, "X"});
+
+    auto toOptimizeFixed = [](OptCalculation<double, 1>& optCalculation) {
+        optCalculation.result = pow(optCalculation.get<X>(), 2);
+    };
+
+    SECTION("Adding") {
+        REQUIRE(optBoundaries.dimensions() == 1);
+        REQUIRE_THROWS(optBoundaries.add_boundary({0.0, 1.0, "Y"}));
+    }
+
+    SECTION("Access") {
+        OptCalculation<double, 1> optCalculation(optBoundaries.get_schema());
+        optCalculation.set<X>(2.0);
+
+        REQUIRE(optCalculation.get<0>() == 2.0);
+        REQUIRE(optCalculation.get_parameter("X") == 2.0);
+        REQUIRE_THROWS(optCalculation.add_parameter("Y", 1.0));
+    }
+
+    SECTION("Optimising") {
+        OptCoordinator<double, false, 1> coordinator(
+            300,
+            toOptimizeFixed,
+            OptTarget::MINIMIZE,
+            0);
+
+        coordinator.add_child(make_unique<OptSimulatedAnnealing<double, 1>>(
+            optBoundaries,
+            0.95,
+            0.25));
+
+        coordinator.add_child(make_unique<OptThresholdAccepting<double, 1>>(
+            optBoundaries,
+            OptTarget::MINIMIZE,
+            0,
+            0.95,
+            5.0,
+            0.95));
+
+        coordinator.add_child(make_unique<OptGreatDeluge<double, 1>>(
+            optBoundaries,
+            OptTarget::MINIMIZE,
+            0,
+            0.95,
+            15.0,
+            0.2));
+
+        coordinator.add_child(make_unique<OptEvolutionary<double, 1>>(
+            optBoundaries,
+            OptTarget::MINIMIZE,
+            0,
+            0.95,
+            50,
+            10,
+            4,
+            0.3));
+
+        coordinator.run_optimisation();
+
+        REQUIRE(fabs(coordinator.get_best_calculation().result - 0.0) < DELTA);
+    }
 }
 
 TEST_CASE("Simulated Annealing") {
@@ -468,6 +1803,7 @@ TEST_CASE("Evolutionary") {
             nIndividualsOffspring,
             mutation));
 
+        coordinator.set_seed(1);
         coordinator.run_optimisation();
 
         REQUIRE(fabs(coordinator.get_best_calculation().result - 0.0) < DELTA);
@@ -492,6 +1828,7 @@ TEST_CASE("Evolutionary") {
             nIndividualsOffspring,
             mutation));
 
+        coordinator.set_seed(1);
         coordinator.run_optimisation();
 
         REQUIRE(fabs(coordinator.get_best_calculation().result - 25.0) < 100.0 * DELTA);  //the evolutionary algorithm has big problems reaching the very edge of a problem, so the delta was increased
@@ -516,6 +1853,7 @@ TEST_CASE("Evolutionary") {
             nIndividualsOffspring,
             mutation));
 
+        coordinator.set_seed(1);
         coordinator.run_optimisation();
 
         REQUIRE(fabs(coordinator.get_best_calculation().result - 3.3) < 100.0 * DELTA);  //the evolutionary algorithm has big problems reaching the very edge of a problem, so the delta was increased
@@ -540,6 +1878,7 @@ TEST_CASE("Evolutionary") {
             nIndividualsOffspring,
             mutation));
 
+        coordinator.set_seed(1);
         coordinator.run_optimisation();
 
         REQUIRE(fabs(coordinator.get_best_calculation().result - 25.0) < 100.0 * DELTA);  //the evolutionary algorithm has big problems reaching the very edge of a problem, so the delta was increased
@@ -564,12 +1903,163 @@ TEST_CASE("Evolutionary") {
             nIndividualsOffspring,
             mutation));
 
+        coordinator.set_seed(1);
         coordinator.run_optimisation();
 
         REQUIRE(fabs(coordinator.get_best_calculation().result - 0.0) < 100.0);
     }
 }
 
+TEST_CASE("Batches") {
+    OptBoundaries<double> optBoundaries;
+    optBoundaries.add_boundary({-5.0, 5.0, "X"});
+
+    vector<OptCalculation<double>> candidates;
+    OptRandom                      random(42);
+    OptSimulatedAnnealing<double>  simulatedAnnealing(optBoundaries, 0.95, 0.25);
+    OptEvolutionary<double>        evolutionary(optBoundaries, OptTarget::MINIMIZE, 0, 0.95, 10, 4, 2, 0.3);
+
+    SECTION("Speculative proposals") {
+        simulatedAnnealing.ask(4, nullptr, random, candidates);
+        REQUIRE(candidates.size() == 4);
+        for (auto const& candidate : candidates)
+            REQUIRE(OptHelper<double>::valid(candidate, optBoundaries));
+    }
+
+    SECTION("Whole generation") {
+        evolutionary.ask(64, nullptr, random, candidates);
+        REQUIRE(candidates.size() == 10);
+    }
+
+    SECTION("Incremental results") {
+        OptEvolutionary<double> elitist(optBoundaries, OptTarget::MINIMIZE, 0, 1.0, 2, 1, 1, 1e-9);
+
+        elitist.ask(64, nullptr, random, candidates);
+        REQUIRE(candidates.size() == 2);
+
+        candidates[0].result = 5.0;
+        candidates[1].result = 1.0;
+        elitist.tell(candidates);
+
+        //the single selected individual is bred with itself and barely mutated
+        vector<OptCalculation<double>> offspring;
+        elitist.ask(64, &candidates[1], random, offspring);
+        REQUIRE(offspring.size() == 1);
+        REQUIRE(fabs(offspring[0].get_parameter("X") - candidates[1].get_parameter("X")) < 1e-6);
+    }
+
+    SECTION("Coordinator") {
+        atomic<unsigned int> nCalculations{0};
+
+        OptCoordinator<double, true> coordinator(
+            300,
+            [&nCalculations](OptCalculation<double>& optCalculation) {
+                ++nCalculations;
+                toOptimize(optCalculation);
+            },
+            OptTarget::MINIMIZE,
+            0);
+
+        coordinator.add_child(make_unique<OptSimulatedAnnealing<double>>(
+            optBoundaries,
+            0.95,
+            0.25));
+
+        coordinator.set_candidates_per_child(8);
+        coordinator.run_optimisation(4);
+
+        REQUIRE(nCalculations == 300u);
+        REQUIRE(fabs(coordinator.get_best_calculation().result - 0.0) < DELTA);
+    }
+
+    SECTION("Deterministic") {
+        auto run = [&optBoundaries](unsigned int nThreads) {
+            OptCoordinator<double, true> coordinator(
+                600,
+                toOptimize,
+                OptTarget::MINIMIZE,
+                0);
+
+            coordinator.add_child(make_unique<OptSimulatedAnnealing<double>>(
+                optBoundaries,
+                0.95,
+                0.25));
+
+            coordinator.add_child(make_unique<OptThresholdAccepting<double>>(
+                optBoundaries,
+                OptTarget::MINIMIZE,
+                0,
+                0.95,
+                1.0,
+                0.995));
+
+            coordinator.add_child(make_unique<OptEvolutionary<double>>(
+                optBoundaries,
+                OptTarget::MINIMIZE,
+                0,
+                0.95,
+                30,
+                10,
+                20,
+                0.1));
+
+            coordinator.set_seed(1337);
+            coordinator.set_candidates_per_child(4);
+            coordinator.enable_deterministic();
+            coordinator.run_optimisation(nThreads);
+
+            auto best = coordinator.get_best_calculation();
+            return make_pair(best.get_parameter("X"), best.result);
+        };
+
+        //bitwise identical, no matter the number of threads
+        const auto single = run(1);
+        REQUIRE(run(4) == single);
+        REQUIRE(run(3) == single);
+    }
+
+    SECTION("Deterministic early abort") {
+        atomic<size_t> nCalculations{0};
+
+        auto setup = [&](auto& coordinator) {
+            for (int i = 0; i < 3; ++i)
+                coordinator.add_child(make_unique<OptSimulatedAnnealing<double>>(
+                    optBoundaries,
+                    0.95,
+                    0.25));
+
+            coordinator.set_seed(1337);
+            coordinator.set_candidates_per_child(4);
+            coordinator.enable_early_abort(0.01);
+        };
+
+        auto counted = [&nCalculations](OptCalculation<double>& optCalculation) {
+            ++nCalculations;
+            toOptimize(optCalculation);
+        };
+
+        OptCoordinator<double, false> singleThreaded(600, counted, OptTarget::MINIMIZE, 0);
+        setup(singleThreaded);
+        singleThreaded.run_optimisation();
+
+        const auto single = make_tuple(singleThreaded.get_best_calculation().get_parameter("X"), singleThreaded.get_best_calculation().result, nCalculations.load());
+        REQUIRE(get<1>(single) < 0.01);
+        REQUIRE(get<2>(single) < 600u);
+
+        //every child stops on its own, so the multi threaded runs evaluate exactly the same calculations
+        for (unsigned int nThreads : {1u, 3u, 4u}) {
+            nCalculations = 0;
+
+            OptCoordinator<double, true> coordinator(600, counted, OptTarget::MINIMIZE, 0);
+            setup(coordinator);
+            coordinator.enable_deterministic();
+            coordinator.run_optimisation(nThreads);
+
+            REQUIRE(make_tuple(coordinator.get_best_calculation().get_parameter("X"), coordinator.get_best_calculation().result, nCalculations.load()) == single);
+        }
+    }
+}
+
 TEST_CASE("Multithreading / Boundary Splitting") {
     OptBoundaries<double>
         optBoundaries1,